@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ws2812.h"
+#include "progmem.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <util/delay.h>
@@ -47,6 +48,29 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
     _delay_us(WS2812_TRST_US);
 }
 
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *map, uint16_t number_of_leds) {
+    DDRx_ADDRESS(RGB_DI_PIN) |= pinmask(RGB_DI_PIN);
+
+    uint8_t masklo = ~(pinmask(RGB_DI_PIN)) & PORTx_ADDRESS(RGB_DI_PIN);
+    uint8_t maskhi = pinmask(RGB_DI_PIN) | PORTx_ADDRESS(RGB_DI_PIN);
+
+    // An interrupt between two LEDs could outlast the reset time and latch half a frame
+    uint8_t sreg_prev = SREG;
+    cli();
+
+    for (uint16_t i = 0; i < number_of_leds; i++) {
+        LED_TYPE led = ledarray[pgm_read_byte(&map[i])];
+#ifdef RGBW
+        convert_rgb_to_rgbw(&led);
+#endif
+        ws2812_sendarray_mask((uint8_t *)&led, sizeof(LED_TYPE), masklo, maskhi);
+    }
+
+    SREG = sreg_prev;
+
+    _delay_us(WS2812_TRST_US);
+}
+
 /*
   This routine writes an array of bytes with RGB values to the Dataout pin
   using the fast 800kHz clockless WS2811/2812 protocol.
@@ -29,8 +29,6 @@
 #include <string.h>
 #include <hal.h>
 
-static uint8_t i2c_address;
-
 static const I2CConfig i2cconfig = {
 #if defined(USE_I2CV1_CONTRIB)
     I2C1_CLOCK_SPEED,
@@ -45,6 +43,69 @@ static const I2CConfig i2cconfig = {
 #endif
 };
 
+#ifdef I2C_BUS_ROUTES
+typedef struct {
+    uint8_t address;
+    uint8_t bus;
+} i2c_route_t;
+
+static I2CDriver* const  i2c_buses[]  = I2C_BUS_DRIVERS;
+static const i2c_route_t i2c_routes[] = I2C_BUS_ROUTES;
+
+#    define I2C_BUS_COUNT (sizeof(i2c_buses) / sizeof(i2c_buses[0]))
+
+uint8_t i2c_address_bus(uint8_t address) {
+    for (uint8_t i = 0; i < sizeof(i2c_routes) / sizeof(i2c_routes[0]); i++) {
+        if (i2c_routes[i].address == address) {
+            return i2c_routes[i].bus;
+        }
+    }
+    return 0;
+}
+
+#    define I2C_BUS(address) (i2c_buses[i2c_address_bus(address)])
+
+// One worker per extra bus; the caller of i2c_run_per_bus() serves the first bus itself
+static void (*volatile i2c_bus_job)(uint8_t bus);
+static binary_semaphore_t i2c_bus_start[I2C_BUS_COUNT];
+static binary_semaphore_t i2c_bus_done[I2C_BUS_COUNT];
+static stkalign_t         i2c_bus_wa[I2C_BUS_COUNT - 1][THD_WORKING_AREA_SIZE(I2C_BUS_THREAD_STACK) / sizeof(stkalign_t)];
+
+static THD_FUNCTION(i2c_bus_thread, arg) {
+    uint8_t bus = (uint8_t)(uintptr_t)arg;
+    chRegSetThreadName("i2c_bus");
+    while (true) {
+        chBSemWait(&i2c_bus_start[bus]);
+        i2c_bus_job(bus);
+        chBSemSignal(&i2c_bus_done[bus]);
+    }
+}
+
+// Runs job(bus) for every bus concurrently and returns once all of them are done
+void i2c_run_per_bus(void (*job)(uint8_t bus)) {
+    static bool threads_started = false;
+    if (!threads_started) {
+        threads_started = true;
+        for (uint8_t bus = 1; bus < I2C_BUS_COUNT; bus++) {
+            chBSemObjectInit(&i2c_bus_start[bus], true);
+            chBSemObjectInit(&i2c_bus_done[bus], true);
+            chThdCreateStatic(i2c_bus_wa[bus - 1], sizeof(i2c_bus_wa[bus - 1]), NORMALPRIO + 1, i2c_bus_thread, (void*)(uintptr_t)bus);
+        }
+    }
+
+    i2c_bus_job = job;
+    for (uint8_t bus = 1; bus < I2C_BUS_COUNT; bus++) {
+        chBSemSignal(&i2c_bus_start[bus]);
+    }
+    job(0);
+    for (uint8_t bus = 1; bus < I2C_BUS_COUNT; bus++) {
+        chBSemWait(&i2c_bus_done[bus]);
+    }
+}
+#else
+#    define I2C_BUS(address) (&I2C_DRIVER)
+#endif
+
 static i2c_status_t chibios_to_qmk(const msg_t* status) {
     switch (*status) {
         case I2C_NO_ERROR:
@@ -78,28 +139,27 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_start(uint8_t address) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2cStart(I2C_BUS(address), &i2cconfig);
     return I2C_STATUS_SUCCESS;
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
+    I2CDriver* bus = I2C_BUS(address);
+    i2cStart(bus, &i2cconfig);
+    msg_t status = i2cMasterTransmitTimeout(bus, (address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
+    I2CDriver* bus = I2C_BUS(address);
+    i2cStart(bus, &i2cconfig);
+    msg_t status = i2cMasterReceiveTimeout(bus, (address >> 1), data, length, TIME_MS2I(timeout));
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    I2CDriver* bus = I2C_BUS(devaddr);
+    i2cStart(bus, &i2cconfig);
 
     uint8_t complete_packet[length + 1];
     for (uint8_t i = 0; i < length; i++) {
@@ -107,15 +167,23 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
     }
     complete_packet[0] = regaddr;
 
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
+    msg_t status = i2cMasterTransmitTimeout(bus, (devaddr >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = devaddr;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
+    I2CDriver* bus = I2C_BUS(devaddr);
+    i2cStart(bus, &i2cconfig);
+    msg_t status = i2cMasterTransmitTimeout(bus, (devaddr >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
     return chibios_to_qmk(&status);
 }
 
+#ifdef I2C_BUS_ROUTES
+void i2c_stop(void) {
+    for (uint8_t bus = 0; bus < I2C_BUS_COUNT; bus++) {
+        i2cStop(i2c_buses[bus]);
+    }
+}
+#else
 void i2c_stop(void) { i2cStop(&I2C_DRIVER); }
+#endif
@@ -81,6 +81,25 @@
 #    define I2C_DRIVER I2CD1
 #endif
 
+/* Devices can be spread over several I2C peripherals so that their transfers
+ * run concurrently. I2C_BUS_DRIVERS lists the peripherals, the first one being
+ * the default bus, and I2C_BUS_ROUTES moves individual (shifted) addresses to
+ * another bus:
+ *
+ *   #define I2C_BUS_DRIVERS { &I2CD1, &I2CD2 }
+ *   #define I2C_BUS_ROUTES { { DRIVER_ADDR_3 << 1, 1 }, { DRIVER_ADDR_4 << 1, 1 } }
+ *
+ * Addresses therefore have to be unique across all buses.
+ */
+#ifdef I2C_BUS_ROUTES
+#    ifndef I2C_BUS_DRIVERS
+#        error "I2C_BUS_ROUTES requires I2C_BUS_DRIVERS to be defined"
+#    endif
+#    ifndef I2C_BUS_THREAD_STACK
+#        define I2C_BUS_THREAD_STACK 256
+#    endif
+#endif
+
 #ifdef USE_GPIOV1
 #    ifndef I2C1_SCL_PAL_MODE
 #        define I2C1_SCL_PAL_MODE PAL_MODE_STM32_ALTERNATE_OPENDRAIN
@@ -111,3 +130,8 @@ i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+#ifdef I2C_BUS_ROUTES
+uint8_t i2c_address_bus(uint8_t address);
+void    i2c_run_per_bus(void (*job)(uint8_t bus));
+#endif
@@ -0,0 +1,9 @@
+ws2812_pwm_encode_DEFS :=
+ws2812_pwm_encode_INC := $(DRIVER_PATH)/chibios
+
+ws2812_pwm_encode_SRC := \
+	$(DRIVER_PATH)/chibios/tests/ws2812_pwm_encode_tests.cpp
+
+ws2812_pwm_encode_rgbw_DEFS := -DRGBW
+ws2812_pwm_encode_rgbw_INC := $(ws2812_pwm_encode_INC)
+ws2812_pwm_encode_rgbw_SRC := $(ws2812_pwm_encode_SRC)
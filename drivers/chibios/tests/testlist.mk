@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	ws2812_pwm_encode\
+	ws2812_pwm_encode_rgbw
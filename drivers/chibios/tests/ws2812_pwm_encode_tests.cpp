@@ -0,0 +1,117 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <vector>
+
+extern "C" {
+#include "ws2812_pwm_encode.h"
+}
+
+using testing::ElementsAreArray;
+
+static const uint16_t ZERO = 10;
+static const uint16_t ONE  = 20;
+
+static LED_TYPE make_led(uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+    LED_TYPE led;
+    led.r = r;
+    led.g = g;
+    led.b = b;
+#ifdef RGBW
+    led.w = w;
+#endif
+    return led;
+}
+
+static void append_byte(std::vector<uint16_t>& bits, uint8_t byte) {
+    for (int bit = 7; bit >= 0; bit--) {
+        bits.push_back((byte >> bit) & 1 ? ONE : ZERO);
+    }
+}
+
+TEST(Ws2812PwmEncode, uses_one_compare_value_per_color_bit) {
+#ifdef RGBW
+    EXPECT_EQ(WS2812_PWM_BITS_PER_LED, 32u);
+#else
+    EXPECT_EQ(WS2812_PWM_BITS_PER_LED, 24u);
+#endif
+}
+
+TEST(Ws2812PwmEncode, sends_the_channels_in_wire_order_msb_first) {
+    LED_TYPE              led = make_led(0x80, 0x01, 0xA5, 0xF0);
+    std::vector<uint16_t> bits(WS2812_PWM_BITS_PER_LED);
+    ws2812_pwm_encode(bits.data(), &led, 1, ZERO, ONE);
+
+    std::vector<uint16_t> expected;
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    append_byte(expected, 0x01);
+    append_byte(expected, 0x80);
+    append_byte(expected, 0xA5);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    append_byte(expected, 0x80);
+    append_byte(expected, 0x01);
+    append_byte(expected, 0xA5);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    append_byte(expected, 0xA5);
+    append_byte(expected, 0x01);
+    append_byte(expected, 0x80);
+#endif
+#ifdef RGBW
+    append_byte(expected, 0xF0);
+#endif
+    EXPECT_THAT(bits, ElementsAreArray(expected));
+}
+
+TEST(Ws2812PwmEncode, encodes_leds_back_to_back) {
+    LED_TYPE              leds[] = {make_led(0xFF, 0xFF, 0xFF, 0xFF), make_led(0, 0, 0, 0)};
+    std::vector<uint16_t> bits(2 * WS2812_PWM_BITS_PER_LED + 1, 0);
+    ws2812_pwm_encode(bits.data(), leds, 2, ZERO, ONE);
+
+    std::vector<uint16_t> expected(WS2812_PWM_BITS_PER_LED, ONE);
+    expected.insert(expected.end(), WS2812_PWM_BITS_PER_LED, ZERO);
+    // Nothing past the last LED is touched, so the reset bits survive
+    expected.push_back(0);
+    EXPECT_THAT(bits, ElementsAreArray(expected));
+}
+
+TEST(Ws2812PwmEncode, encodes_nothing_for_zero_leds) {
+    LED_TYPE              led = make_led(0xFF, 0xFF, 0xFF, 0xFF);
+    std::vector<uint16_t> bits(WS2812_PWM_BITS_PER_LED, 0);
+    ws2812_pwm_encode(bits.data(), &led, 0, ZERO, ONE);
+
+    EXPECT_THAT(bits, ElementsAreArray(std::vector<uint16_t>(WS2812_PWM_BITS_PER_LED, 0)));
+}
+
+TEST(Ws2812PwmEncode, ends_the_frame_right_after_the_last_led) {
+    LED_TYPE              led = make_led(0, 0, 0, 0);
+    std::vector<uint16_t> bits(3 * WS2812_PWM_BITS_PER_LED, ONE);
+    ws2812_pwm_encode(bits.data(), &led, 1, ZERO, ONE);
+    uint32_t length = ws2812_pwm_end_frame(bits.data(), 1, 5);
+
+    // what an older, longer frame left behind is past the end of this one
+    EXPECT_EQ(length, WS2812_PWM_BITS_PER_LED + 5);
+    std::vector<uint16_t> expected(WS2812_PWM_BITS_PER_LED, ZERO);
+    expected.insert(expected.end(), 5, 0);
+    EXPECT_THAT(std::vector<uint16_t>(bits.begin(), bits.begin() + length), ElementsAreArray(expected));
+}
+
+TEST(Ws2812PwmEncode, ends_an_empty_frame_with_the_reset_period_alone) {
+    std::vector<uint16_t> bits(8, ONE);
+    EXPECT_EQ(ws2812_pwm_end_frame(bits.data(), 0, 4), 4);
+    EXPECT_THAT(std::vector<uint16_t>(bits.begin(), bits.begin() + 4), ElementsAreArray(std::vector<uint16_t>(4, 0)));
+}
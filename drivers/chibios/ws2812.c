@@ -1,5 +1,6 @@
 #include "quantum.h"
 #include "ws2812.h"
+#include "progmem.h"
 #include <ch.h>
 #include <hal.h>
 
@@ -76,9 +77,31 @@ void sendByte(uint8_t byte) {
 
 void ws2812_init(void) { palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE); }
 
+static void sendLed(LED_TYPE *led) {
+    // WS2812 protocol dictates grb order
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    sendByte(led->g);
+    sendByte(led->r);
+    sendByte(led->b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    sendByte(led->r);
+    sendByte(led->g);
+    sendByte(led->b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    sendByte(led->b);
+    sendByte(led->g);
+    sendByte(led->r);
+#endif
+
+#ifdef RGBW
+    sendByte(led->w);
+#endif
+}
+
+static bool s_init = false;
+
 // Setleds for standard RGB
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
-    static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
@@ -88,24 +111,29 @@ void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
     chSysLock();
 
     for (uint8_t i = 0; i < leds; i++) {
-        // WS2812 protocol dictates grb order
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-        sendByte(ledarray[i].r);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].b);
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-        sendByte(ledarray[i].b);
-        sendByte(ledarray[i].g);
-        sendByte(ledarray[i].r);
-#endif
+        sendLed(&ledarray[i]);
+    }
 
+    wait_ns(RES);
+
+    chSysUnlock();
+}
+
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *map, uint16_t leds) {
+    if (!s_init) {
+        ws2812_init();
+        s_init = true;
+    }
+
+    // this code is very time dependent, so we need to disable interrupts
+    chSysLock();
+
+    for (uint8_t i = 0; i < leds; i++) {
+        LED_TYPE led = ledarray[pgm_read_byte(&map[i])];
 #ifdef RGBW
-        sendByte(ledarray[i].w);
+        convert_rgb_to_rgbw(&led);
 #endif
+        sendLed(&led);
     }
 
     wait_ns(RES);
@@ -1,13 +1,11 @@
 #include "ws2812.h"
+#include "ws2812_pwm_encode.h"
+#include "progmem.h"
 #include "quantum.h"
 #include <hal.h>
 
 /* Adapted from https://github.com/joewa/WS2812-LED-Driver_ChibiOS/ */
 
-#ifdef RGBW
-#    error "RGBW not supported"
-#endif
-
 #ifndef WS2812_PWM_DRIVER
 #    define WS2812_PWM_DRIVER PWMD2  // TIMx
 #endif
@@ -60,8 +58,8 @@
  * Calculate the number of zeroes to add at the end assuming 1.25 uS/bit:
  */
 #define WS2812_RESET_BIT_N (1000 * WS2812_TRST_US / 1250)
-#define WS2812_COLOR_BIT_N (RGBLED_NUM * 24)                   /**< Number of data bits */
-#define WS2812_BIT_N (WS2812_COLOR_BIT_N + WS2812_RESET_BIT_N) /**< Total number of bits in a frame */
+#define WS2812_COLOR_BIT_N (RGBLED_NUM * WS2812_PWM_BITS_PER_LED) /**< Number of data bits */
+#define WS2812_BIT_N (WS2812_COLOR_BIT_N + WS2812_RESET_BIT_N)    /**< Total number of bits in a frame */
 
 /**
  * @brief   High period for a zero, in ticks
@@ -94,147 +92,43 @@
  */
 #define WS2812_DUTYCYCLE_1 (WS2812_PWM_FREQUENCY / (1000000000 / 800))
 
-/* --- PRIVATE MACROS ------------------------------------------------------- */
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given bit
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] byte:                 The byte number [0, 2]
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#define WS2812_BIT(led, byte, bit) (24 * (led) + 8 * (byte) + (7 - (bit)))
-
-#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
- *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 1, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 2, (bit))
-
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
- *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 1, (bit))
-
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 2, (bit))
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
 
-#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
 /**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given red bit
+ * @brief   Frame buffers, one halfword per bit
  *
- * @note    The red byte is the middle byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
+ * The DMA sends one buffer while the next frame is encoded into the other. Every
+ * duty cycle fits in 16 bits, which halves the RAM of a word per bit.
  */
-#    define WS2812_RED_BIT(led, bit) WS2812_BIT((led), 2, (bit))
+static uint16_t ws2812_frame_buffer[2][WS2812_BIT_N + 1];
+static uint8_t  ws2812_back_buffer = 0; /**< Index of the buffer that is not being sent */
 
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given green bit
- *
- * @note    The red byte is the first byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit number [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_GREEN_BIT(led, bit) WS2812_BIT((led), 1, (bit))
+static binary_semaphore_t ws2812_frame_sent; /**< Taken while a frame is being sent, released by the DMA */
 
-/**
- * @brief   Determine the index in @ref ws2812_frame_buffer "the frame buffer" of a given blue bit
- *
- * @note    The red byte is the last byte in the color packet
- *
- * @param[in] led:                  The led index [0, @ref RGBLED_NUM)
- * @param[in] bit:                  The bit index [0, 7]
- *
- * @return                          The bit index
- */
-#    define WS2812_BLUE_BIT(led, bit) WS2812_BIT((led), 0, (bit))
-#endif
+/* --- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
-/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+static void ws2812_dma_complete(void* param, uint32_t flags) {
+    (void)param;
 
-static uint32_t ws2812_frame_buffer[WS2812_BIT_N + 1]; /**< Buffer for a frame */
+    // on an error the frame is cut short, but the next one can still go out
+    if (flags & (STM32_DMA_ISR_TCIF | STM32_DMA_ISR_TEIF)) {
+        chSysLockFromISR();
+        chBSemSignalI(&ws2812_frame_sent);
+        chSysUnlockFromISR();
+    }
+}
 
 /* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
-/*
- * Gedanke: Double-buffer type transactions: double buffer transfers using two memory pointers for
-the memory (while the DMA is reading/writing from/to a buffer, the application can
-write/read to/from the other buffer).
- */
 
 void ws2812_init(void) {
-    // Initialize led frame buffer
-    uint32_t i;
-    for (i = 0; i < WS2812_COLOR_BIT_N; i++) ws2812_frame_buffer[i] = WS2812_DUTYCYCLE_0;      // All color bits are zero duty cycle
-    for (i = 0; i < WS2812_RESET_BIT_N; i++) ws2812_frame_buffer[i + WS2812_COLOR_BIT_N] = 0;  // All reset bits are zero
+    // Initialize led frame buffers
+    for (uint8_t buffer = 0; buffer < 2; buffer++) {
+        uint32_t i;
+        for (i = 0; i < WS2812_COLOR_BIT_N; i++) ws2812_frame_buffer[buffer][i] = WS2812_DUTYCYCLE_0;              // All color bits are zero duty cycle
+        for (i = 0; i < WS2812_RESET_BIT_N + 1; i++) ws2812_frame_buffer[buffer][i + WS2812_COLOR_BIT_N] = 0;  // All reset bits are zero
+    }
+
+    chBSemObjectInit(&ws2812_frame_sent, false);
 
     palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE);
 
@@ -256,21 +150,17 @@ void ws2812_init(void) {
 
     // Configure DMA
     // dmaInit(); // Joe added this
-    dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL);
+    dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, ws2812_dma_complete, NULL);
     dmaStreamSetPeripheral(WS2812_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1]));  // Ziel ist der An-Zeit im Cap-Comp-Register
-    dmaStreamSetMemory0(WS2812_DMA_STREAM, ws2812_frame_buffer);
-    dmaStreamSetTransactionSize(WS2812_DMA_STREAM, WS2812_BIT_N);
-    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3));
-    // M2P: Memory 2 Periph; PL: Priority Level
+    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_HWORD | STM32_DMA_CR_MSIZE_HWORD | STM32_DMA_CR_MINC | STM32_DMA_CR_PL(3) | STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE);
+    // M2P: Memory 2 Periph; PL: Priority Level; TCIE, TEIE: call ws2812_dma_complete()
+    // Not circular: each frame is sent once, see ws2812_setleds()
 
 #if (STM32_DMA_SUPPORTS_DMAMUX == TRUE)
     // If the MCU has a DMAMUX we need to assign the correct resource
     dmaSetRequestSource(WS2812_DMA_STREAM, WS2812_DMAMUX_ID);
 #endif
 
-    // Start DMA
-    dmaStreamEnable(WS2812_DMA_STREAM);
-
     // Configure PWM
     // NOTE: It's required that preload be enabled on the timer channel CCR register. This is currently enabled in the
     // ChibiOS driver code, so we don't have to do anything special to the timer. If we did, we'd have to start the timer,
@@ -279,24 +169,52 @@ void ws2812_init(void) {
     pwmEnableChannel(&WS2812_PWM_DRIVER, WS2812_PWM_CHANNEL - 1, 0);  // Initial period is 0; output will be low until first duty cycle is DMA'd in
 }
 
-void ws2812_write_led(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b) {
-    // Write color to frame buffer
-    for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-    }
+static void ws2812_send_frame(uint16_t* frame, uint16_t leds) {
+    uint32_t length = ws2812_pwm_end_frame(frame, leds, WS2812_RESET_BIT_N + 1);
+
+    // The previous frame, including its reset bits, is normally long gone by now.
+    // If not, sleep until the DMA says so rather than spinning.
+    chBSemWait(&ws2812_frame_sent);
+
+    dmaStreamDisable(WS2812_DMA_STREAM);
+    dmaStreamSetMemory0(WS2812_DMA_STREAM, frame);
+    dmaStreamSetTransactionSize(WS2812_DMA_STREAM, length);
+    dmaStreamEnable(WS2812_DMA_STREAM);
+
+    ws2812_back_buffer ^= 1;
 }
 
-// Setleds for standard RGB
+static bool s_init = false;
+
+// Setleds for standard RGB and RGBW
 void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
-    static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
     }
 
+    if (leds > RGBLED_NUM) leds = RGBLED_NUM;
+
+    uint16_t* frame = ws2812_frame_buffer[ws2812_back_buffer];
+    ws2812_pwm_encode(frame, ledarray, leds, WS2812_DUTYCYCLE_0, WS2812_DUTYCYCLE_1);
+    ws2812_send_frame(frame, leds);
+}
+
+void ws2812_setleds_mapped(LED_TYPE* ledarray, const uint8_t* map, uint16_t leds) {
+    if (!s_init) {
+        ws2812_init();
+        s_init = true;
+    }
+
+    if (leds > RGBLED_NUM) leds = RGBLED_NUM;
+
+    uint16_t* frame = ws2812_frame_buffer[ws2812_back_buffer];
     for (uint16_t i = 0; i < leds; i++) {
-        ws2812_write_led(i, ledarray[i].r, ledarray[i].g, ledarray[i].b);
+        LED_TYPE led = ledarray[pgm_read_byte(&map[i])];
+#ifdef RGBW
+        convert_rgb_to_rgbw(&led);
+#endif
+        ws2812_pwm_encode(frame + i * WS2812_PWM_BITS_PER_LED, &led, 1, WS2812_DUTYCYCLE_0, WS2812_DUTYCYCLE_1);
     }
+    ws2812_send_frame(frame, leds);
 }
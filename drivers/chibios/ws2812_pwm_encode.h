@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include "color.h"
+
+/* LED_TYPE lays out its channels in the order they go out on the wire (see
+ * WS2812_BYTE_ORDER), so an LED is simply its bytes sent MSB first. */
+#define WS2812_PWM_BITS_PER_LED (sizeof(LED_TYPE) * 8)
+
+/**
+ * @brief   Expand LED colors into one timer compare value per bit
+ *
+ * @param[out] bits:                The frame buffer, WS2812_PWM_BITS_PER_LED entries per LED
+ * @param[in] leds:                 The colors to encode
+ * @param[in] count:                The number of LEDs
+ * @param[in] duty_0:               The compare value that sends a zero
+ * @param[in] duty_1:               The compare value that sends a one
+ */
+static inline void ws2812_pwm_encode(uint16_t *bits, const LED_TYPE *leds, uint16_t count, uint16_t duty_0, uint16_t duty_1) {
+    const uint8_t *byte = (const uint8_t *)leds;
+    const uint8_t *end  = byte + count * sizeof(LED_TYPE);
+
+    for (; byte < end; byte++) {
+        for (uint8_t mask = 0x80; mask; mask >>= 1) {
+            *bits++ = (*byte & mask) ? duty_1 : duty_0;
+        }
+    }
+}
+
+/**
+ * @brief   End a frame right after its last LED with the reset period
+ *
+ * A double buffered frame buffer still holds whatever an older frame left past
+ * the LEDs just encoded. Holding the line low straight after them means none of
+ * that is ever sent.
+ *
+ * @param[out] bits:                The frame buffer
+ * @param[in] count:                The number of LEDs encoded into it
+ * @param[in] reset_bits:           The number of bit periods to hold the line low
+ * @return                          The number of compare values to send
+ */
+static inline uint32_t ws2812_pwm_end_frame(uint16_t *bits, uint16_t count, uint16_t reset_bits) {
+    uint32_t length = (uint32_t)count * WS2812_PWM_BITS_PER_LED;
+
+    for (uint16_t i = 0; i < reset_bits; i++) {
+        bits[length + i] = 0;
+    }
+    return length + reset_bits;
+}
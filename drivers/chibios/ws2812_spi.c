@@ -1,5 +1,6 @@
 #include "quantum.h"
 #include "ws2812.h"
+#include "progmem.h"
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -91,8 +92,19 @@ void ws2812_init(void) {
     spiSelect(&WS2812_SPI);         /* Slave Select assertion.          */
 }
 
+static void ws2812_send(void) {
+    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
+    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
+#ifdef WS2812_SPI_SYNC
+    spiSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+#else
+    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+#endif
+}
+
+static bool s_init = false;
+
 void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
-    static bool s_init = false;
     if (!s_init) {
         ws2812_init();
         s_init = true;
@@ -102,11 +114,18 @@ void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
         set_led_color_rgb(ledarray[i], i);
     }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
-#else
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
-#endif
+    ws2812_send();
+}
+
+void ws2812_setleds_mapped(LED_TYPE* ledarray, const uint8_t* map, uint16_t leds) {
+    if (!s_init) {
+        ws2812_init();
+        s_init = true;
+    }
+
+    for (uint8_t i = 0; i < leds; i++) {
+        set_led_color_rgb(ledarray[pgm_read_byte(&map[i])], i);
+    }
+
+    ws2812_send();
 }
@@ -0,0 +1,143 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix.h"
+#include "i2c_master.h"
+
+// One LED per chip, so every chip has a dirty PWM buffer after set_color_all
+const is31_led g_is31_leds[DRIVER_LED_TOTAL] = {
+    {0, C1_1, C2_1, C3_1},
+    {1, C1_2, C2_2, C3_2},
+    {2, C1_3, C2_3, C3_3},
+    {3, C1_4, C2_4, C3_4},
+};
+
+void wait_ms(uint32_t ms) {}
+}
+
+#define MAX_BUSES 4
+
+// 400 kHz bus: 9 clocks per byte including the address byte, plus start and stop
+static const uint32_t NS_PER_CLOCK = 2500;
+
+static const uint8_t chip_addr[DRIVER_COUNT] = {DRIVER_ADDR_1, DRIVER_ADDR_2, DRIVER_ADDR_3, DRIVER_ADDR_4};
+
+// Simulated buses: each one is only ever touched by the thread serving it
+static uint8_t  route[128];
+static uint8_t  bus_count;
+static uint64_t bus_time_ns[MAX_BUSES];
+static uint8_t  chip_regs[128][256];
+
+extern "C" i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t chip = address >> 1;
+    bus_time_ns[route[chip]] += ((length + 1) * 9 + 2) * NS_PER_CLOCK;
+    // Registers auto-increment after the first data byte
+    for (uint16_t i = 1; i < length; i++) {
+        chip_regs[chip][(uint8_t)(data[0] + i - 1)] = data[i];
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+extern "C" void i2c_init(void) {}
+
+extern "C" uint8_t i2c_address_bus(uint8_t address) { return route[address >> 1]; }
+
+// Same contract as the ChibiOS implementation: one worker per extra bus, the caller serves bus 0
+extern "C" void i2c_run_per_bus(void (*job)(uint8_t bus)) {
+    std::vector<std::thread> workers;
+    for (uint8_t bus = 1; bus < bus_count; bus++) {
+        workers.emplace_back(job, bus);
+    }
+    job(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+class Is31fl3731MultiBus : public testing::Test {
+   public:
+    Is31fl3731MultiBus() {
+        memset(route, 0, sizeof(route));
+        memset(chip_regs, 0, sizeof(chip_regs));
+        bus_count = 1;
+    }
+
+    void use_buses(std::vector<uint8_t> chip_buses) {
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            route[chip_addr[i]] = chip_buses[i];
+            bus_count           = std::max<uint8_t>(bus_count, chip_buses[i] + 1);
+        }
+    }
+
+    // Flushes a frame with every chip dirty, returns the simulated frame time in ns
+    uint64_t flush_frame(void) {
+        memset(bus_time_ns, 0, sizeof(bus_time_ns));
+        rgb_matrix_driver.set_color_all(0x10, 0x20, 0x30);
+        rgb_matrix_driver.flush();
+
+        uint64_t frame_time_ns = *std::max_element(bus_time_ns, bus_time_ns + MAX_BUSES);
+        RecordProperty("frame_time_us", frame_time_ns / 1000);
+        return frame_time_ns;
+    }
+};
+
+TEST_F(Is31fl3731MultiBus, single_bus_pays_for_every_chip) {
+    uint64_t frame_time_ns = flush_frame();
+    // 9 transfers of 16 PWM registers per chip
+    EXPECT_EQ(frame_time_ns, DRIVER_COUNT * 9 * ((17 + 1) * 9 + 2) * NS_PER_CLOCK);
+}
+
+TEST_F(Is31fl3731MultiBus, two_buses_halve_the_frame_time) {
+    uint64_t sequential_ns = flush_frame();
+    use_buses({0, 0, 1, 1});
+    EXPECT_EQ(flush_frame() * 2, sequential_ns);
+}
+
+TEST_F(Is31fl3731MultiBus, one_bus_per_chip_takes_one_chip_time) {
+    uint64_t sequential_ns = flush_frame();
+    use_buses({0, 1, 2, 3});
+    EXPECT_EQ(flush_frame() * DRIVER_COUNT, sequential_ns);
+}
+
+TEST_F(Is31fl3731MultiBus, frame_time_is_set_by_the_busiest_bus) {
+    uint64_t sequential_ns = flush_frame();
+    use_buses({0, 0, 0, 1});
+    EXPECT_EQ(flush_frame() * DRIVER_COUNT, sequential_ns * 3);
+}
+
+TEST_F(Is31fl3731MultiBus, concurrent_flush_delivers_every_chip_its_own_pwm_data) {
+    use_buses({0, 1, 2, 3});
+    for (int frame = 0; frame < 50; frame++) {
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            rgb_matrix_driver.set_color(i, frame, i, 0xFF - i);
+        }
+        rgb_matrix_driver.flush();
+
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            uint8_t* regs = chip_regs[chip_addr[i]];
+            ASSERT_EQ(regs[g_is31_leds[i].r], frame);
+            ASSERT_EQ(regs[g_is31_leds[i].g], i);
+            ASSERT_EQ(regs[g_is31_leds[i].b], 0xFF - i);
+        }
+    }
+}
@@ -0,0 +1,7 @@
+is31fl3731_multi_bus_DEFS := -DIS31FL3731 -DI2C_BUS_ROUTES -DMATRIX_ROWS=1 -DMATRIX_COLS=4 -DDRIVER_COUNT=4 -DDRIVER_LED_TOTAL=4 -DDRIVER_ADDR_1=0x74 -DDRIVER_ADDR_2=0x75 -DDRIVER_ADDR_3=0x76 -DDRIVER_ADDR_4=0x77
+is31fl3731_multi_bus_INC := $(DRIVER_PATH)/issi/tests $(DRIVER_PATH)/issi
+
+is31fl3731_multi_bus_SRC := \
+	$(DRIVER_PATH)/issi/tests/is31fl3731_multi_bus_tests.cpp \
+	$(DRIVER_PATH)/issi/is31fl3731.c \
+	$(QUANTUM_PATH)/rgb_matrix_drivers.c
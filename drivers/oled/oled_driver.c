@@ -151,6 +151,16 @@ static void InvertCharacter(uint8_t *cursor) {
     }
 }
 
+// Marks all blocks overlapping the buffer range [start_index, end_index) as dirty
+static void oled_mark_dirty(uint16_t start_index, uint16_t end_index) {
+    uint8_t first_block = start_index / OLED_BLOCK_SIZE;
+    uint8_t last_block  = (end_index - 1) / OLED_BLOCK_SIZE;
+    oled_dirty |= (OLED_BLOCK_TYPE)(OLED_ALL_BLOCKS_MASK >> (OLED_BLOCK_COUNT - 1 - (last_block - first_block))) << first_block;
+}
+
+// Returns the number of pages, rows of 8 pixels, in the current rotation
+static uint8_t oled_rotation_pages(void) { return OLED_MATRIX_SIZE / oled_rotation_width; }
+
 bool oled_init(uint8_t rotation) {
     oled_rotation = oled_init_user(rotation);
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
@@ -225,10 +235,10 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint16_t start_index, uint16_t size, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint8_t start_page   = start_index / OLED_DISPLAY_WIDTH;
+    uint8_t start_column = start_index % OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
@@ -240,10 +250,15 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = NOP;
 #else
     // Commands for use in Horizontal Addressing mode.
+    // Updates spanning several pages always start at the first column, see oled_render_size
     cmd_array[1] = start_column;
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    if (start_column + size > OLED_DISPLAY_WIDTH) {
+        cmd_array[2] = OLED_DISPLAY_WIDTH - 1;
+    } else {
+        cmd_array[2] = start_column + size - 1;
+    }
+    cmd_array[5] = (start_index + size - 1) / OLED_DISPLAY_WIDTH;
 #endif
 }
 
@@ -255,19 +270,64 @@ static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
-}
-
+// Rotates an 8x8 pixel tile by transposing the bit matrix, each row of the source becomes
+// a column of the destination. The tile is split in two 32bit halves and the bits are
+// exchanged with delta swaps, see "Hacker's Delight" 7-3 Transposing a Bit Matrix.
 static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
+    uint32_t x = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+    uint32_t y = ((uint32_t)src[4] << 24) | ((uint32_t)src[5] << 16) | ((uint32_t)src[6] << 8) | src[7];
+    uint32_t t;
+
+    // Transpose the 2x2 bit blocks, then the 4x4 blocks inside each half
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+
+    // Swap the 4x4 blocks between the two halves
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    dest[0] = y;
+    dest[1] = y >> 8;
+    dest[2] = y >> 16;
+    dest[3] = y >> 24;
+    dest[4] = x;
+    dest[5] = x >> 8;
+    dest[6] = x >> 16;
+    dest[7] = x >> 24;
+}
+
+// Returns the number of bytes, starting at the first dirty block, that can be sent with a
+// single address window and data transfer. Adjacent dirty blocks are merged as long as
+// they fit in the remaining budget and in the addressing window of the display.
+static uint16_t oled_render_size(uint8_t update_start, uint16_t budget) {
+    uint16_t start_index = OLED_BLOCK_SIZE * update_start;
+    uint16_t size        = OLED_BLOCK_SIZE;
+    for (uint8_t i = update_start + 1; i < OLED_BLOCK_COUNT; ++i) {
+        if (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << i)) || size + OLED_BLOCK_SIZE > budget) {
+            break;
+        }
+#if (OLED_IC == OLED_IC_SH1106)
+        // Page Addressing Mode doesn't advance to the next page
+        if (start_index % OLED_DISPLAY_WIDTH + size + OLED_BLOCK_SIZE > OLED_DISPLAY_WIDTH) {
+            break;
+        }
+#else
+        // The column window wraps back to the start column, so only updates starting at
+        // the first column can span several pages
+        if (start_index % OLED_DISPLAY_WIDTH != 0 && start_index % OLED_DISPLAY_WIDTH + size + OLED_BLOCK_SIZE > OLED_DISPLAY_WIDTH) {
+            break;
         }
+#endif
+        size += OLED_BLOCK_SIZE;
     }
+    return size;
 }
 
 void oled_render(void) {
@@ -281,55 +341,64 @@ void oled_render(void) {
         return;
     }
 
-    // Find first dirty block
-    uint8_t update_start = 0;
-    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
-        ++update_start;
-    }
-
-    // Set column & page position
-    static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
-    } else {
-        calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
-    }
+    // Always send at least the first dirty block
+    uint16_t budget = OLED_RENDER_BYTE_LIMIT > OLED_BLOCK_SIZE ? OLED_RENDER_BYTE_LIMIT : OLED_BLOCK_SIZE;
+    while (oled_dirty && budget >= OLED_BLOCK_SIZE) {
+        // Find first dirty block
+        uint8_t update_start = 0;
+        while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
+            ++update_start;
+        }
 
-    // Send column & page position
-    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
-        print("oled_render offset command failed\n");
-        return;
-    }
+        // Set column & page position
+        static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+        uint16_t       update_size     = OLED_BLOCK_SIZE;
+        if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+            update_size = oled_render_size(update_start, budget);
+            calc_bounds(OLED_BLOCK_SIZE * update_start, update_size, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        } else {
+            calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+        }
 
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render data failed\n");
+        // Send column & page position
+        if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
+            print("oled_render offset command failed\n");
             return;
         }
-    } else {
-        // Rotate the render chunks
-        const static uint8_t source_map[] = OLED_SOURCE_MAP;
-        const static uint8_t target_map[] = OLED_TARGET_MAP;
-
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
-        }
 
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render90 data failed\n");
-            return;
+        if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+            // Send render data chunk as is
+            if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], update_size) != I2C_STATUS_SUCCESS) {
+                print("oled_render data failed\n");
+                return;
+            }
+        } else {
+            // Rotate the render chunks
+            const static uint8_t source_map[] = OLED_SOURCE_MAP;
+            const static uint8_t target_map[] = OLED_TARGET_MAP;
+
+            static uint8_t temp_buffer[OLED_BLOCK_SIZE];
+            memset(temp_buffer, 0, sizeof(temp_buffer));
+            for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+                rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+            }
+
+            // Send render data chunk after rotating
+            if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+                print("oled_render90 data failed\n");
+                return;
+            }
         }
-    }
 
-    // Turn on display if it is off
-    oled_on();
+        // Turn on display if it is off
+        oled_on();
 
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+        // Clear dirty flags of the blocks sent
+        for (uint16_t sent = 0; sent < update_size; sent += OLED_BLOCK_SIZE) {
+            oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start++);
+        }
+        budget -= update_size;
+    }
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -504,6 +573,141 @@ void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
     }
 }
 
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    uint8_t max_height = oled_rotation_pages() * 8;
+    if (x >= oled_rotation_width || y >= max_height || width == 0 || height == 0) {
+        return;
+    }
+    if (width > oled_rotation_width - x) {
+        width = oled_rotation_width - x;
+    }
+    if (height > max_height - y) {
+        height = max_height - y;
+    }
+
+    uint8_t end_y = y + height;
+    for (uint8_t page = y / 8; page * 8 < end_y; page++) {
+        // Bits of this page covered by the rectangle
+        uint8_t mask = 0xFF;
+        if (y > page * 8) {
+            mask &= 0xFF << (y - page * 8);
+        }
+        if (end_y < page * 8 + 8) {
+            mask &= 0xFF >> (page * 8 + 8 - end_y);
+        }
+
+        uint16_t start_index = page * oled_rotation_width + x;
+        bool     changed     = false;
+        for (uint16_t i = start_index; i < start_index + width; i++) {
+            uint8_t data = on ? oled_buffer[i] | mask : oled_buffer[i] & ~mask;
+            if (oled_buffer[i] != data) {
+                oled_buffer[i] = data;
+                changed        = true;
+            }
+        }
+        if (changed) {
+            oled_mark_dirty(start_index, start_index + width);
+        }
+    }
+}
+
+static void oled_write_raw_rect_internal(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages, bool progmem) {
+    uint8_t max_pages = oled_rotation_pages();
+    if (x >= oled_rotation_width || page >= max_pages) {
+        return;
+    }
+    // Clipped columns are skipped in the source data, which keeps its full width
+    uint8_t stride = width;
+    if (width > oled_rotation_width - x) {
+        width = oled_rotation_width - x;
+    }
+    if (pages > max_pages - page) {
+        pages = max_pages - page;
+    }
+
+    for (uint8_t row = 0; row < pages; row++) {
+        const char *src         = data + row * stride;
+        uint16_t    start_index = (page + row) * oled_rotation_width + x;
+        bool        changed     = false;
+        for (uint16_t i = start_index; i < start_index + width; i++) {
+            uint8_t c = progmem ? pgm_read_byte(src++) : *src++;
+            if (oled_buffer[i] != c) {
+                oled_buffer[i] = c;
+                changed        = true;
+            }
+        }
+        if (changed) {
+            oled_mark_dirty(start_index, start_index + width);
+        }
+    }
+}
+
+void oled_write_raw_rect(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) { oled_write_raw_rect_internal(data, x, page, width, pages, false); }
+
+void oled_pan_rect(bool left, uint8_t x, uint8_t page, uint8_t width, uint8_t pages, uint8_t amount) {
+    uint8_t max_pages = oled_rotation_pages();
+    if (x >= oled_rotation_width || page >= max_pages || width == 0 || amount == 0) {
+        return;
+    }
+    if (width > oled_rotation_width - x) {
+        width = oled_rotation_width - x;
+    }
+    if (pages > max_pages - page) {
+        pages = max_pages - page;
+    }
+    if (amount > width) {
+        amount = width;
+    }
+
+    for (uint8_t row = 0; row < pages; row++) {
+        uint16_t start_index = (page + row) * oled_rotation_width + x;
+        uint8_t *start       = &oled_buffer[start_index];
+        // The columns uncovered by the move are cleared
+        if (left) {
+            memmove(start, start + amount, width - amount);
+            memset(start + width - amount, 0, amount);
+        } else {
+            memmove(start + amount, start, width - amount);
+            memset(start, 0, amount);
+        }
+        oled_mark_dirty(start_index, start_index + width);
+    }
+}
+
+void oled_write_raw_rle_P(const char *data, uint16_t size) {
+    uint16_t    index       = oled_cursor - &oled_buffer[0];
+    uint16_t    start_index = index;
+    const char *end         = data + size;
+    bool        changed     = false;
+    while (data < end && index < OLED_MATRIX_SIZE) {
+        uint8_t control = pgm_read_byte(data++);
+        if (control < 128) {
+            // Literal run of control + 1 bytes
+            for (uint8_t count = control + 1; count > 0 && data < end && index < OLED_MATRIX_SIZE; count--) {
+                uint8_t c = pgm_read_byte(data++);
+                if (oled_buffer[index] != c) {
+                    oled_buffer[index] = c;
+                    changed            = true;
+                }
+                index++;
+            }
+        } else if (data < end) {
+            // A single byte repeated control - 126 times
+            uint8_t c = pgm_read_byte(data++);
+            for (uint8_t count = control - 126; count > 0 && index < OLED_MATRIX_SIZE; count--) {
+                if (oled_buffer[index] != c) {
+                    oled_buffer[index] = c;
+                    changed            = true;
+                }
+                index++;
+            }
+        }
+    }
+    if (changed) {
+        oled_mark_dirty(start_index, index);
+    }
+}
+
 #if defined(__AVR__)
 void oled_write_P(const char *data, bool invert) {
     uint8_t c = pgm_read_byte(data);
@@ -528,6 +732,8 @@ void oled_write_raw_P(const char *data, uint16_t size) {
         oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
     }
 }
+
+void oled_write_raw_rect_P(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) { oled_write_raw_rect_internal(data, x, page, width, pages, true); }
 #endif  // defined(__AVR__)
 
 bool oled_on(void) {
@@ -158,6 +158,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_I2C_TIMEOUT 100
 #endif
 
+// Maximum number of bytes sent to the display per oled_render call, at least one block is always sent.
+// Adjacent dirty blocks are merged into a single transfer, at 400kHz each byte takes about 22.5us on the bus.
+#if !defined(OLED_RENDER_BYTE_LIMIT)
+#    define OLED_RENDER_BYTE_LIMIT OLED_BLOCK_SIZE
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
@@ -227,6 +233,23 @@ void oled_write_raw_byte(const char data, uint16_t index);
 // Coordinates start at top-left and go right and down for positive x and y
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
 
+// Sets or clears all pixels of a rectangle, clipped to the display
+// Coordinates start at top-left and go right and down for positive x and y
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Copies raw data into a rectangle starting at column x and page (row of 8 pixels) page
+// data holds width bytes per page, in the same layout as the display buffer
+void oled_write_raw_rect(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);
+
+// Pans a rectangle of the buffer to the right (or left by passing true) by amount pixels
+// The columns uncovered by panning are cleared
+void oled_pan_rect(bool left, uint8_t x, uint8_t page, uint8_t width, uint8_t pages, uint8_t amount);
+
+// Decodes run-length encoded PROGMEM data into the buffer at current cursor position
+// size is the encoded size. A control byte below 128 is followed by control + 1 literal
+// bytes, any other control byte is followed by a single byte repeated control - 126 times
+void oled_write_raw_rle_P(const char *data, uint16_t size);
+
 #if defined(__AVR__)
 // Writes a PROGMEM string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -240,6 +263,10 @@ void oled_write_P(const char *data, bool invert);
 void oled_write_ln_P(const char *data, bool invert);
 
 void oled_write_raw_P(const char *data, uint16_t size);
+
+// Copies raw PROGMEM data into a rectangle, see oled_write_raw_rect
+// Remapped to call 'void oled_write_raw_rect(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);' on ARM
+void oled_write_raw_rect_P(const char *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);
 #else
 // Writes a string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -251,6 +278,8 @@ void oled_write_raw_P(const char *data, uint16_t size);
 #    define oled_write_ln_P(data, invert) oled_write(data, invert)
 
 #    define oled_write_raw_P(data, size) oled_write_raw(data, size)
+
+#    define oled_write_raw_rect_P(data, x, page, width, pages) oled_write_raw_rect(data, x, page, width, pages)
 #endif  // defined(__AVR__)
 
 // Can be used to manually turn on the screen if it is off
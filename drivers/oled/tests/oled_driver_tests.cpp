@@ -0,0 +1,370 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// The batched test target overrides the render limit, the default one renders a block per call
+#if defined(OLED_RENDER_BYTE_LIMIT)
+#    define BATCHED_RENDER
+#endif
+
+extern "C" {
+#include "oled_driver.h"
+#include "i2c_master.h"
+
+extern OLED_BLOCK_TYPE oled_dirty;
+}
+
+using testing::ElementsAre;
+
+#define I2C_CMD 0x00
+#define I2C_DATA 0x40
+#define COLUMN_ADDR 0x21
+#define PAGE_ADDR 0x22
+
+class OledDriver : public testing::Test {
+   public:
+    OledDriver() {
+        Instance = this;
+        oled_init(OLED_ROTATION_0);
+        transfers.clear();
+    }
+
+    ~OledDriver() { Instance = nullptr; }
+
+    // Renders until nothing is dirty, returns the number of oled_render calls needed
+    int render_all(void) {
+        int renders = 0;
+        while (true) {
+            size_t num_transfers = transfers.size();
+            oled_render();
+            if (transfers.size() == num_transfers) {
+                return renders;
+            }
+            renders++;
+        }
+    }
+
+    size_t bytes_on_bus(void) {
+        size_t bytes = 0;
+        for (auto& transfer : transfers) {
+            bytes += transfer.size();
+        }
+        return bytes;
+    }
+
+    std::vector<std::vector<uint8_t>> transfers;
+
+    static OledDriver* Instance;
+};
+
+OledDriver* OledDriver::Instance = nullptr;
+
+extern "C" {
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (OledDriver::Instance) {
+        OledDriver::Instance->transfers.emplace_back(data, data + length);
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (OledDriver::Instance) {
+        std::vector<uint8_t> transfer(1, regaddr);
+        transfer.insert(transfer.end(), data, data + length);
+        OledDriver::Instance->transfers.push_back(transfer);
+    }
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+uint8_t buffer_at(uint16_t index) { return oled_read_raw(index).current_element[0]; }
+
+TEST_F(OledDriver, fills_rectangle_with_partial_pages) {
+    render_all();
+    oled_fill_rect(10, 4, 3, 10, true);
+    for (uint8_t x = 9; x < 14; x++) {
+        bool inside = x >= 10 && x < 13;
+        EXPECT_EQ(buffer_at(x), inside ? 0xF0 : 0);
+        EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + x), inside ? 0x3F : 0);
+        EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH * 2 + x), 0);
+    }
+    oled_fill_rect(11, 0, 1, 16, false);
+    EXPECT_EQ(buffer_at(11), 0);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 11), 0);
+    EXPECT_EQ(buffer_at(12), 0xF0);
+}
+
+TEST_F(OledDriver, fill_rectangle_marks_only_touched_blocks_dirty) {
+    render_all();
+    transfers.clear();
+    oled_fill_rect(OLED_BLOCK_SIZE - 2, 0, 4, 8, true);
+    render_all();
+    size_t data_bytes = 0;
+    for (size_t i = 1; i < transfers.size(); i += 2) {
+        data_bytes += transfers[i].size() - 1;
+    }
+    EXPECT_EQ(data_bytes, OLED_BLOCK_SIZE * 2);
+}
+
+TEST_F(OledDriver, fill_rectangle_is_clipped_to_the_display) {
+    oled_fill_rect(OLED_DISPLAY_WIDTH - 1, OLED_DISPLAY_HEIGHT - 1, 20, 20, true);
+    EXPECT_EQ(buffer_at(OLED_MATRIX_SIZE - 1), 0x80);
+    EXPECT_EQ(buffer_at(OLED_MATRIX_SIZE - 2), 0);
+    oled_fill_rect(OLED_DISPLAY_WIDTH, 0, 1, 1, true);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH), 0);
+}
+
+TEST_F(OledDriver, writes_raw_rectangle) {
+    const char data[] = {1, 2, 3, 4, 5, 6};
+    oled_write_raw_rect(data, 4, 1, 3, 2);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 3), 0);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 4), 1);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 6), 3);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 7), 0);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH * 2 + 4), 4);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH * 2 + 6), 6);
+}
+
+TEST_F(OledDriver, clipped_raw_rectangle_keeps_source_stride) {
+    const char data[] = {1, 2, 3, 4};
+    oled_write_raw_rect(data, OLED_DISPLAY_WIDTH - 1, 0, 2, 2);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH - 1), 1);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH * 2 - 1), 3);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH * 2), 0);
+}
+
+TEST_F(OledDriver, pans_rectangle) {
+    const char data[] = {1, 2, 3, 4, 5};
+    oled_write_raw_rect(data, 0, 0, 5, 1);
+    oled_write_raw_rect(data, 0, 1, 5, 1);
+    oled_pan_rect(true, 1, 0, 4, 1, 2);
+    EXPECT_EQ(buffer_at(0), 1);
+    EXPECT_EQ(buffer_at(1), 4);
+    EXPECT_EQ(buffer_at(2), 5);
+    EXPECT_EQ(buffer_at(3), 0);
+    EXPECT_EQ(buffer_at(4), 0);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 1), 2);
+    oled_pan_rect(false, 0, 1, 5, 1, 1);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH), 0);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 1), 1);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 4), 4);
+    EXPECT_EQ(buffer_at(OLED_DISPLAY_WIDTH + 5), 0);
+}
+
+TEST_F(OledDriver, decodes_run_length_encoded_data) {
+    // 3 literal bytes, 0xAA repeated 5 times, 1 literal byte
+    const char data[] = {2, 1, 2, 3, (char)(5 + 126), (char)0xAA, 0, 9};
+    oled_set_cursor(1, 0);
+    oled_write_raw_rle_P(data, sizeof(data));
+    uint8_t expected[] = {1, 2, 3, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 9, 0};
+    for (uint8_t i = 0; i < sizeof(expected); i++) {
+        EXPECT_EQ(buffer_at(OLED_FONT_WIDTH + i), expected[i]);
+    }
+}
+
+TEST_F(OledDriver, run_length_decoding_stops_at_end_of_buffer) {
+    const char data[] = {(char)255, 7, (char)255, 7, (char)255, 7, (char)255, 7, (char)255, 7};
+    oled_set_cursor(0, OLED_DISPLAY_HEIGHT / 8 - 1);
+    oled_write_raw_rle_P(data, sizeof(data));
+    EXPECT_EQ(buffer_at(OLED_MATRIX_SIZE - 1), 7);
+    EXPECT_EQ(buffer_at(OLED_MATRIX_SIZE - OLED_DISPLAY_WIDTH - 1), 0);
+}
+
+// The tile rotation used before the bit matrix transpose, kept as a reference
+static uint8_t crot(uint8_t a, int8_t n) {
+    const uint8_t mask = 0x7;
+    n &= mask;
+    return a << n | a >> (-n & mask);
+}
+
+static void reference_rotate_90(const uint8_t* src, uint8_t* dest) {
+    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
+        uint8_t selector = (1 << i);
+        for (uint8_t j = 0; j < 8; ++j) {
+            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
+        }
+    }
+}
+
+TEST_F(OledDriver, rotated_render_matches_reference_rotation) {
+    oled_init(OLED_ROTATION_90);
+    uint8_t buffer[OLED_MATRIX_SIZE];
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        buffer[i] = i * 37 + (i >> 3);
+        oled_write_raw_byte(buffer[i], i);
+    }
+    transfers.clear();
+    render_all();
+    ASSERT_EQ(transfers.size(), OLED_BLOCK_COUNT * 2);
+
+    const uint8_t source_map[] = OLED_SOURCE_MAP;
+    const uint8_t target_map[] = OLED_TARGET_MAP;
+    for (uint8_t block = 0; block < OLED_BLOCK_COUNT; block++) {
+        uint8_t expected[OLED_BLOCK_SIZE] = {0};
+        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+            reference_rotate_90(&buffer[OLED_BLOCK_SIZE * block + source_map[i]], &expected[target_map[i]]);
+        }
+        auto& data = transfers[block * 2 + 1];
+        ASSERT_EQ(data.size(), OLED_BLOCK_SIZE + 1);
+        EXPECT_TRUE(std::equal(expected, expected + OLED_BLOCK_SIZE, data.begin() + 1)) << "block " << (int)block;
+    }
+}
+
+// Best time of 200 renders of the whole screen, with nothing recorded on the bus
+static std::chrono::nanoseconds best_full_render(oled_rotation_t rotation) {
+    oled_init(rotation);
+    OledDriver* instance = OledDriver::Instance;
+    OledDriver::Instance = nullptr;
+
+    std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+    for (int run = 0; run < 200; run++) {
+        // render masks off the bits past the last block
+        oled_dirty = (OLED_BLOCK_TYPE)~0;
+        auto start = std::chrono::steady_clock::now();
+        while (oled_dirty) {
+            oled_render();
+        }
+        best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    OledDriver::Instance = instance;
+    return best;
+}
+
+// Times the rotation of a whole screen against the loop used before the bit
+// matrix transpose. The rotation's share of a render is what a rotated render
+// costs over an unrotated one, the old loop is timed rotating the same tiles.
+TEST_F(OledDriver, rotation_benchmark) {
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        oled_write_raw_byte(i * 37 + (i >> 3), i);
+    }
+    std::chrono::nanoseconds rotated   = best_full_render(OLED_ROTATION_90);
+    std::chrono::nanoseconds unrotated = best_full_render(OLED_ROTATION_0);
+
+    const uint8_t*           screen    = (const uint8_t*)oled_read_raw(0).current_element;
+    std::chrono::nanoseconds reference = std::chrono::nanoseconds::max();
+    uint8_t                  tiles[OLED_MATRIX_SIZE];
+    for (int run = 0; run < 200; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint16_t tile = 0; tile < OLED_MATRIX_SIZE; tile += 8) {
+            std::fill(tiles + tile, tiles + tile + 8, 0);
+            reference_rotate_90(screen + tile, tiles + tile);
+        }
+        // keep the compiler from dropping the unused tiles
+        asm volatile("" : : "r"(tiles) : "memory");
+        reference = std::min(reference, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    RecordProperty("width", OLED_DISPLAY_WIDTH);
+    RecordProperty("height", OLED_DISPLAY_HEIGHT);
+    RecordProperty("rotated_render_ns", (int)rotated.count());
+    RecordProperty("unrotated_render_ns", (int)unrotated.count());
+    RecordProperty("rotation_ns", (int)(rotated - unrotated).count());
+    RecordProperty("reference_rotation_ns", (int)reference.count());
+}
+
+#if !defined(BATCHED_RENDER)
+
+TEST_F(OledDriver, renders_one_block_per_call) {
+    EXPECT_EQ(render_all(), OLED_BLOCK_COUNT);
+    EXPECT_EQ(transfers.size(), OLED_BLOCK_COUNT * 2);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, 0, OLED_BLOCK_SIZE - 1, PAGE_ADDR, 0, 0));
+    EXPECT_EQ(transfers[1].size(), OLED_BLOCK_SIZE + 1);
+    EXPECT_EQ(bytes_on_bus(), OLED_BLOCK_COUNT * (7 + OLED_BLOCK_SIZE + 1));
+}
+
+TEST_F(OledDriver, renders_nothing_when_not_dirty) {
+    render_all();
+    transfers.clear();
+    oled_render();
+    EXPECT_EQ(transfers.size(), 0);
+}
+
+TEST_F(OledDriver, renders_only_the_dirty_block) {
+    render_all();
+    transfers.clear();
+    oled_write_pixel(OLED_DISPLAY_WIDTH - 1, 8, true);
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 2);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, OLED_DISPLAY_WIDTH - OLED_BLOCK_SIZE, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 1, 1));
+    EXPECT_EQ(transfers[1].back(), 1);
+}
+
+#else
+
+TEST_F(OledDriver, renders_full_screen_in_one_call) {
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 2);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1));
+    EXPECT_EQ(transfers[1].size(), OLED_MATRIX_SIZE + 1);
+    EXPECT_EQ(transfers[1][0], I2C_DATA);
+    EXPECT_EQ(bytes_on_bus(), 7 + OLED_MATRIX_SIZE + 1);
+}
+
+TEST_F(OledDriver, sends_separate_windows_for_non_adjacent_blocks) {
+    render_all();
+    transfers.clear();
+    oled_write_pixel(0, 0, true);
+    oled_write_pixel(OLED_BLOCK_SIZE * 2, 0, true);
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 4);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, 0, OLED_BLOCK_SIZE - 1, PAGE_ADDR, 0, 0));
+    EXPECT_THAT(transfers[2], ElementsAre(I2C_CMD, COLUMN_ADDR, OLED_BLOCK_SIZE * 2, OLED_BLOCK_SIZE * 3 - 1, PAGE_ADDR, 0, 0));
+}
+
+TEST_F(OledDriver, merges_adjacent_blocks_within_a_page) {
+    render_all();
+    transfers.clear();
+    oled_write_pixel(OLED_BLOCK_SIZE, 0, true);
+    oled_write_pixel(OLED_BLOCK_SIZE * 2, 0, true);
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 2);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, OLED_BLOCK_SIZE, OLED_BLOCK_SIZE * 3 - 1, PAGE_ADDR, 0, 0));
+    EXPECT_EQ(transfers[1].size(), OLED_BLOCK_SIZE * 2 + 1);
+}
+
+TEST_F(OledDriver, splits_window_at_page_end_when_not_starting_at_first_column) {
+    render_all();
+    transfers.clear();
+    oled_write_pixel(OLED_DISPLAY_WIDTH - 1, 0, true);
+    oled_write_pixel(0, 8, true);
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 4);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, OLED_DISPLAY_WIDTH - OLED_BLOCK_SIZE, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, 0));
+    EXPECT_THAT(transfers[2], ElementsAre(I2C_CMD, COLUMN_ADDR, 0, OLED_BLOCK_SIZE - 1, PAGE_ADDR, 1, 1));
+}
+
+TEST_F(OledDriver, spans_pages_when_starting_at_first_column) {
+    render_all();
+    transfers.clear();
+    for (uint8_t x = 0; x < OLED_DISPLAY_WIDTH; x += OLED_BLOCK_SIZE) {
+        oled_write_pixel(x, 0, true);
+    }
+    oled_write_pixel(0, 8, true);
+    EXPECT_EQ(render_all(), 1);
+    ASSERT_EQ(transfers.size(), 2);
+    EXPECT_THAT(transfers[0], ElementsAre(I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, 1));
+    EXPECT_EQ(transfers[1].size(), OLED_DISPLAY_WIDTH + OLED_BLOCK_SIZE + 1);
+}
+
+#endif
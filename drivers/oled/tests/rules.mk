@@ -0,0 +1,15 @@
+oled_driver_DEFS := -DNO_PRINT -DNO_DEBUG
+oled_driver_INC := $(DRIVER_PATH)/oled/tests $(DRIVER_PATH)/oled
+
+oled_driver_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_driver_tests.cpp \
+	$(DRIVER_PATH)/oled/oled_driver.c \
+	$(TMK_PATH)/common/test/timer.c
+
+oled_driver_batched_DEFS := $(oled_driver_DEFS) -DOLED_RENDER_BYTE_LIMIT=OLED_MATRIX_SIZE
+oled_driver_batched_INC := $(oled_driver_INC)
+oled_driver_batched_SRC := $(oled_driver_SRC)
+
+oled_driver_128x64_DEFS := $(oled_driver_DEFS) -DOLED_DISPLAY_128X64
+oled_driver_128x64_INC := $(oled_driver_INC)
+oled_driver_128x64_SRC := $(oled_driver_SRC)
@@ -0,0 +1,4 @@
+TEST_LIST +=\
+	oled_driver\
+	oled_driver_batched\
+	oled_driver_128x64
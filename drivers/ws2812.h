@@ -38,3 +38,10 @@
  *         - Wait 50us to reset the LEDs
  */
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds);
+
+/*
+ * As above, but LED i on the strip shows ledarray[map[i]], with map stored in
+ * PROGMEM. Drivers apply the map and the RGBW conversion while sending, so no
+ * remapped copy of the frame is needed.
+ */
+void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *map, uint16_t number_of_leds);
@@ -1,4 +1,5 @@
 from . import api
+from . import audio_songs
 from . import config_h
 from . import dfu_header
 from . import docs
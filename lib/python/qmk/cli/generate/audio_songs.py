@@ -0,0 +1,233 @@
+"""Generate a header with songs compiled for audio_play_compiled_melody().
+"""
+import ast
+import operator
+import re
+import sys
+
+from milc import cli
+
+import qmk.path
+from qmk.constants import QMK_FIRMWARE
+
+MUSICAL_NOTES_H = QMK_FIRMWARE / 'quantum' / 'audio' / 'musical_notes.h'
+SONG_LIST_H = QMK_FIRMWARE / 'quantum' / 'audio' / 'song_list.h'
+
+# Order of note_frequency_lut in quantum/audio/luts.c, after NOTE_REST
+NOTE_NAMES = ['C', 'CS', 'D', 'DS', 'E', 'F', 'FS', 'G', 'GS', 'A', 'AS', 'B']
+NOTE_OCTAVES = 9
+COMPILED_NOTE_RUN = 0x80
+MAX_RUN = 256
+
+# Operators allowed in note durations, e.g. MUSICAL_NOTE(note, 16 + 8)
+DURATION_OPERATORS = {
+    ast.Add: operator.add,
+    ast.Sub: operator.sub,
+    ast.Mult: operator.mul,
+    ast.Div: operator.floordiv,
+}
+
+# Python 3.7 parses numbers into ast.Num, later versions into ast.Constant
+NUMBER_NODES = (ast.Constant, ast.Num) if sys.version_info < (3, 8) else (ast.Constant,)
+
+
+def _read_defines(path):
+    """Returns the #defines of a header as {name: (params, body)}, with comments and line continuations removed.
+    """
+    text = path.read_text(encoding='utf-8')
+    text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', '', text)
+    text = text.replace('\\\n', ' ')
+
+    defines = {}
+    for match in re.finditer(r'^\s*#\s*define\s+(\w+)(\(([^)]*)\))?[ \t]*(.*)$', text, flags=re.M):
+        params = [p.strip() for p in match.group(3).split(',')] if match.group(2) else None
+        defines[match.group(1)] = (params, match.group(4).strip())
+
+    return defines
+
+
+def _duration(expression):
+    """Evaluates the integer arithmetic of a note duration like `16 + 8`.
+    """
+    def evaluate(node):
+        if isinstance(node, NUMBER_NODES):
+            value = node.value if isinstance(node, ast.Constant) else node.n
+            if type(value) is int:
+                return value
+        if isinstance(node, ast.BinOp) and type(node.op) in DURATION_OPERATORS:
+            return DURATION_OPERATORS[type(node.op)](evaluate(node.left), evaluate(node.right))
+        raise ValueError('Unsupported note duration %s' % expression)
+
+    try:
+        return evaluate(ast.parse(expression.strip(), mode='eval').body)
+    except (SyntaxError, ZeroDivisionError):
+        raise ValueError('Unsupported note duration %s' % expression)
+
+
+def _note_indexes(defines):
+    """Maps each NOTE_* name, including the flat aliases, to its index into note_frequency_lut.
+    """
+    indexes = {'NOTE_REST': 0}
+    for octave in range(NOTE_OCTAVES):
+        for i, name in enumerate(NOTE_NAMES):
+            indexes['NOTE_%s%d' % (name, octave)] = 1 + octave * 12 + i
+
+    for name, (params, body) in defines.items():
+        if name.startswith('NOTE_') and params is None and body in indexes:
+            indexes[name] = indexes[body]
+
+    return indexes
+
+
+def _note_durations(defines):
+    """Maps each note type macro (Q__NOTE, QUARTER_DOT_NOTE, ...) to its duration, or None for M__NOTE style macros taking the duration as argument.
+    """
+    durations = {}
+
+    def resolve(name):
+        if name in durations:
+            return durations[name]
+        params, body = defines[name]
+        match = re.fullmatch(r'(\w+)\(\s*(\w+)\s*(?:,\s*(.+?))?\s*\)', body)
+        if not match:
+            raise ValueError('Unknown note type %s' % name)
+        if match.group(1) == 'MUSICAL_NOTE':
+            duration = match.group(3)
+            durations[name] = None if duration in params else _duration(duration)
+        else:
+            durations[name] = resolve(match.group(1))
+        return durations[name]
+
+    for name, (params, body) in defines.items():
+        if name != 'MUSICAL_NOTE' and params and body.startswith(tuple(n for n in defines if n.endswith('NOTE'))):
+            resolve(name)
+
+    return durations
+
+
+def compile_songs(musical_notes_h, song_list_h, names=None, base_song_list_h=SONG_LIST_H):
+    """Parses the songs in `song_list_h` into lists of (note index, duration) tuples, the duration in 64th of a beat.
+
+    The songs of `base_song_list_h` can be named in `names` and used in the songs of `song_list_h`, like a keymap's songs can use those of song_list.h.
+    """
+    notes = _read_defines(musical_notes_h)
+    note_indexes = _note_indexes(notes)
+    note_durations = _note_durations(notes)
+    own_songs = _read_defines(song_list_h)
+    songs = _read_defines(base_song_list_h) if base_song_list_h else {}
+    songs.update(own_songs)
+
+    def expand(name):
+        result = []
+        for token in re.finditer(r'(\w+)(?:\(\s*(_\w+)\s*(?:,\s*([^)]+?))?\s*\))?', songs[name][1]):
+            macro, note, duration = token.groups()
+            if note is not None:
+                if macro not in note_durations:
+                    raise ValueError('%s: unknown note type %s' % (name, macro))
+                if 'NOTE' + note not in note_indexes:
+                    raise ValueError('%s: unknown note %s' % (name, note))
+                result.append((note_indexes['NOTE' + note], note_durations[macro] if note_durations[macro] is not None else _duration(duration)))
+            elif macro in songs and songs[macro][0] is None:
+                result.extend(expand(macro))
+            else:
+                raise ValueError('%s: can not compile %s' % (name, macro))
+        return result
+
+    compiled = {}
+    for name in names or own_songs:
+        if name not in songs:
+            raise ValueError('No song named %s' % name)
+        params, body = songs[name]
+        # skip the function-like helpers and empty placeholders like NO_SOUND
+        if params is None and body and (names or 'NOTE(' in body):
+            compiled[name] = expand(name)
+
+    return compiled
+
+
+def encode_song(song, tempo, rle=False):
+    """Encodes a song into the compiled_song_t record stream.
+    """
+    records = []
+    for index, duration in song:
+        ms = duration * 60 * 1000 // (64 * tempo)
+        if ms > 0xFFFF:
+            raise ValueError('A note of %d/64 beats does not fit into 16bit ms at %d bpm' % (duration, tempo))
+        if rle and records and records[-1][:2] == [index, ms] and records[-1][2] < MAX_RUN:
+            records[-1][2] += 1
+        else:
+            records.append([index, ms, 1])
+
+    data = []
+    for index, ms, run in records:
+        if run > 1:
+            data.extend([index | COMPILED_NOTE_RUN, ms & 0xFF, ms >> 8, run - 1])
+        else:
+            data.extend([index, ms & 0xFF, ms >> 8])
+
+    return data
+
+
+@cli.argument('-i', '--input', arg_only=True, type=qmk.path.normpath, default=SONG_LIST_H, help='Header with the SONG macros to compile, which can also use the songs of quantum/audio/song_list.h. Default: quantum/audio/song_list.h')
+@cli.argument('-s', '--song', arg_only=True, action='append', help='Name of a song macro to compile, from the input or quantum/audio/song_list.h, can be given multiple times. Default: all songs in the input')
+@cli.argument('-t', '--tempo', arg_only=True, type=int, default=120, help='Tempo in beats-per-minute to compute the durations for. Default: 120')
+@cli.argument('-r', '--rle', arg_only=True, action='store_true', help='Run-length encode repeated notes')
+@cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help='Quiet mode, only output error messages')
+@cli.subcommand('Compiles SONGs into a header for audio_play_compiled_melody.')
+def generate_audio_songs(cli):
+    """Generate a header with PROGMEM songs for PLAY_COMPILED_SONG, with integer note indexes and durations in ms.
+    """
+    if not 10 <= cli.args.tempo <= 255:
+        cli.log.error('Tempo must be between 10 and 255')
+        return False
+
+    try:
+        songs = compile_songs(MUSICAL_NOTES_H, cli.args.input, cli.args.song)
+    except ValueError as e:
+        cli.log.error(str(e))
+        return False
+
+    header = '''#pragma once
+
+#include "audio.h"
+#include "progmem.h"
+
+// clang-format off
+
+// Compiled by 'qmk generate-audio-songs' at {0:d} bpm
+'''.format(cli.args.tempo)
+
+    float_size = 0
+    compiled_size = 0
+    for name, song in songs.items():
+        try:
+            data = encode_song(song, cli.args.tempo, cli.args.rle)
+        except ValueError as e:
+            cli.log.error('%s: %s', name, e)
+            return False
+
+        float_size += len(song) * 8
+        compiled_size += len(data)
+
+        values = ''
+        for pos in range(0, len(data), 12):
+            values += '    ' + ', '.join('0x{:02X}'.format(b) for b in data[pos:pos + 12]) + ',\n'
+
+        header += '''
+static const uint8_t PROGMEM {0}_song_notes[] = {{
+{1}}};
+static const compiled_song_t {0}_song = {{{0}_song_notes, {2:d}, {3:d}}};
+'''.format(name.lower(), values, len(song), cli.args.tempo)
+
+    if cli.args.output:
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        if cli.args.output.exists():
+            cli.args.output.replace(cli.args.output.parent / (cli.args.output.name + '.bak'))
+        cli.args.output.write_text(header)
+
+        if not cli.args.quiet:
+            cli.log.info('Wrote %d songs to %s, %d bytes instead of %d as float arrays.', len(songs), cli.args.output, compiled_size, float_size)
+    else:
+        print(header)
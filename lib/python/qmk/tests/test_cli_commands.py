@@ -232,6 +232,14 @@ def test_generate_rgb_breathe_table():
     assert 'Breathing max:    127' in result.stdout
 
 
+def test_generate_audio_songs():
+    result = check_subcommand('generate-audio-songs', '-s', 'STARTUP_SOUND', '-s', 'ODE_TO_JOY', '-r')
+    check_returncode(result)
+    assert 'static const uint8_t PROGMEM startup_sound_song_notes[] = {' in result.stdout
+    assert '0x4D, 0x3E, 0x00, 0x52, 0x3E, 0x00, 0x59, 0x5D, 0x00,' in result.stdout
+    assert 'static const compiled_song_t ode_to_joy_song = {ode_to_joy_song_notes, 15, 120};' in result.stdout
+
+
 def test_generate_config_h():
     result = check_subcommand('generate-config-h', '-kb', 'handwired/pytest/basic')
     check_returncode(result)
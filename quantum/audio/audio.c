@@ -16,6 +16,7 @@
  */
 #include "audio.h"
 #include "eeconfig.h"
+#include "progmem.h"
 #include "timer.h"
 #include "wait.h"
 
@@ -81,6 +82,13 @@ uint16_t current_note                 = 0;              // index into the array
 bool     note_resting                 = false;          // if a short pause was introduced between two notes with the same frequency while playing a melody
 uint16_t last_timestamp               = 0;
 
+audio_freq_t           melody_current_pitch = 0;     // pitch of the note last started from the melody
+const compiled_song_t *compiled_song        = NULL;  // or a SONG compiled by 'qmk generate-audio-songs', instead of notes_pointer
+// read position in the compiled_song: the record holding note 'compiled_song_index', which repeats 'compiled_song_run' times
+uint16_t compiled_song_offset = 0;
+uint16_t compiled_song_index  = 0;
+uint8_t  compiled_song_run    = 0;
+
 #ifdef AUDIO_ENABLE_TONE_MULTIPLEXING
 #    ifndef AUDIO_MAX_SIMULTANEOUS_TONES
 #        define AUDIO_MAX_SIMULTANEOUS_TONES 3
@@ -131,7 +139,7 @@ void audio_init() {
 #endif  // EEPROM settings
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = AUDIO_FREQ(-1), .duration = 0};
     }
 
     if (!audio_initialized) {
@@ -192,17 +200,13 @@ void audio_stop_all() {
     melody_current_note_duration = 0;
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = AUDIO_FREQ(-1), .duration = 0};
     }
 
     audio_driver_stopped = true;
 }
 
-void audio_stop_tone(float pitch) {
-    if (pitch < 0.0f) {
-        pitch = -1 * pitch;
-    }
-
+static void audio_stop_tone_fixed(audio_freq_t pitch) {
     if (playing_note) {
         if (!audio_initialized) {
             audio_init();
@@ -211,10 +215,10 @@ void audio_stop_tone(float pitch) {
         for (int i = AUDIO_TONE_STACKSIZE - 1; i >= 0; i--) {
             found = (tones[i].pitch == pitch);
             if (found) {
-                tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                tones[i] = (musical_tone_t){.time_started = 0, .pitch = AUDIO_FREQ(-1), .duration = 0};
                 for (int j = i; (j < AUDIO_TONE_STACKSIZE - 1); j++) {
                     tones[j]     = tones[j + 1];
-                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = AUDIO_FREQ(-1), .duration = 0};
                 }
                 break;
             }
@@ -239,7 +243,9 @@ void audio_stop_tone(float pitch) {
     }
 }
 
-void audio_play_note(float pitch, uint16_t duration) {
+void audio_stop_tone(float pitch) { audio_stop_tone_fixed(AUDIO_FREQ(fabsf(pitch))); }
+
+static void audio_play_note_fixed(audio_freq_t pitch, uint16_t duration) {
     if (!audio_config.enable) {
         return;
     }
@@ -248,10 +254,6 @@ void audio_play_note(float pitch, uint16_t duration) {
         audio_init();
     }
 
-    if (pitch < 0.0f) {
-        pitch = -1 * pitch;
-    }
-
     // round-robin: shifting out old tones, keeping only unique ones
     // if the new frequency is already amongst the active tones, shift it to the top of the stack
     bool found = false;
@@ -288,8 +290,62 @@ void audio_play_note(float pitch, uint16_t duration) {
     }
 }
 
+void audio_play_note(float pitch, uint16_t duration) { audio_play_note_fixed(AUDIO_FREQ(fabsf(pitch)), duration); }
+
 void audio_play_tone(float pitch) { audio_play_note(pitch, 0xffff); }
 
+/* Moves the read position of the compiled_song to the record holding note
+ * 'index'; records are only walked forward, so going back (= looping) starts
+ * over from the first one.
+ */
+static uint16_t compiled_song_seek(uint16_t index) {
+    if (index < compiled_song_index || compiled_song_run == 0) {
+        compiled_song_offset = 0;
+        compiled_song_index  = 0;
+        compiled_song_run    = 1 + ((pgm_read_byte(compiled_song->notes) & COMPILED_NOTE_RUN) ? pgm_read_byte(compiled_song->notes + 3) : 0);
+    }
+    while (index >= compiled_song_index + compiled_song_run) {
+        compiled_song_offset += (pgm_read_byte(compiled_song->notes + compiled_song_offset) & COMPILED_NOTE_RUN) ? 4 : 3;
+        compiled_song_index += compiled_song_run;
+
+        uint8_t pitch     = pgm_read_byte(compiled_song->notes + compiled_song_offset);
+        compiled_song_run = 1 + ((pitch & COMPILED_NOTE_RUN) ? pgm_read_byte(compiled_song->notes + compiled_song_offset + 3) : 0);
+    }
+    return compiled_song_offset;
+}
+
+static audio_freq_t melody_note_pitch(uint16_t index) {
+    if (compiled_song) {
+        uint8_t note = pgm_read_byte(compiled_song->notes + compiled_song_seek(index)) & ~COMPILED_NOTE_RUN;
+        return pgm_read_dword(&note_frequency_lut[note]);
+    }
+    return AUDIO_FREQ(fabsf((*notes_pointer)[index][0]));
+}
+
+static uint16_t melody_note_duration(uint16_t index) {
+    if (compiled_song) {
+        const uint8_t *record   = compiled_song->notes + compiled_song_seek(index);
+        uint16_t       duration = pgm_read_byte(record + 1) | (pgm_read_byte(record + 2) << 8);
+        // the durations were compiled for the song's tempo, only rescale if the user changed it
+        if (note_tempo == compiled_song->tempo) return duration;
+        // slowing a long note down can take it past what the 16bit note timers can hold
+        uint32_t scaled = (uint32_t)duration * compiled_song->tempo / note_tempo;
+        return scaled > UINT16_MAX ? UINT16_MAX : scaled;
+    }
+    return audio_duration_to_ms((*notes_pointer)[index][1]);
+}
+
+static void audio_start_melody(void) {
+    current_note = 0;  // note in the melody-array/list at note_pointer
+
+    // start first note manually, which also starts the audio_driver
+    // all following/remaining notes are played by 'audio_update_state'
+    melody_current_pitch         = melody_note_pitch(current_note);
+    melody_current_note_duration = melody_note_duration(current_note);
+    audio_play_note_fixed(melody_current_pitch, melody_current_note_duration);
+    last_timestamp = timer_read();
+}
+
 void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
     if (!audio_config.enable) {
         audio_stop_all();
@@ -307,16 +363,37 @@ void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
     note_resting   = false;
 
     notes_pointer = np;
+    compiled_song = NULL;
     notes_count   = n_count;
     notes_repeat  = n_repeat;
 
-    current_note = 0;  // note in the melody-array/list at note_pointer
+    audio_start_melody();
+}
 
-    // start first note manually, which also starts the audio_driver
-    // all following/remaining notes are played by 'audio_update_state'
-    audio_play_note((*notes_pointer)[current_note][0], audio_duration_to_ms((*notes_pointer)[current_note][1]));
-    last_timestamp               = timer_read();
-    melody_current_note_duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+void audio_play_compiled_melody(const compiled_song_t *song, bool n_repeat) {
+    if (!audio_config.enable) {
+        audio_stop_all();
+        return;
+    }
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    // Cancel note if a note is playing
+    if (playing_note) audio_stop_all();
+
+    playing_melody = true;
+    note_resting   = false;
+
+    compiled_song        = song;
+    compiled_song_offset = 0;
+    compiled_song_index  = 0;
+    compiled_song_run    = 0;
+    notes_count          = song->count;
+    notes_repeat         = n_repeat;
+
+    audio_start_melody();
 }
 
 float click[2][2];
@@ -351,12 +428,12 @@ float audio_get_frequency(uint8_t tone_index) {
     if (tone_index >= active_tones) {
         return 0.0f;
     }
-    return tones[active_tones - tone_index - 1].pitch;
+    return AUDIO_FREQ_TO_FLOAT(tones[active_tones - tone_index - 1].pitch);
 }
 
-float audio_get_processed_frequency(uint8_t tone_index) {
+audio_freq_t audio_get_processed_frequency_fixed(uint8_t tone_index) {
     if (tone_index >= active_tones) {
-        return 0.0f;
+        return 0;
     }
 
     int8_t index = active_tones - tone_index - 1;
@@ -368,13 +445,15 @@ float audio_get_processed_frequency(uint8_t tone_index) {
         index += active_tones;
 #endif
 
-    if (tones[index].pitch <= 0.0f) {
-        return 0.0f;
+    if (tones[index].pitch <= 0) {
+        return 0;
     }
 
     return voice_envelope(tones[index].pitch);
 }
 
+float audio_get_processed_frequency(uint8_t tone_index) { return AUDIO_FREQ_TO_FLOAT(audio_get_processed_frequency_fixed(tone_index)); }
+
 bool audio_update_state(void) {
     if (!playing_note && !playing_melody) {
         return false;
@@ -390,6 +469,7 @@ bool audio_update_state(void) {
             last_timestamp         = current_time;
             uint16_t previous_note = current_note;
             current_note++;
+            audio_freq_t pitch;
             voices_timer = timer_read();  // reset to zero, for the effects added by voices.c
 
             if (current_note >= notes_count) {
@@ -401,12 +481,13 @@ bool audio_update_state(void) {
                 }
             }
 
-            if (!note_resting && (*notes_pointer)[previous_note][0] == (*notes_pointer)[current_note][0]) {
+            pitch = melody_note_pitch(current_note);
+            if (!note_resting && pitch == melody_current_pitch) {
                 note_resting = true;
 
                 // special handling for successive notes of the same frequency:
                 // insert a short pause to separate them audibly
-                audio_play_note(0.0f, audio_duration_to_ms(2));
+                audio_play_note_fixed(0, audio_duration_to_ms(2));
                 current_note                 = previous_note;
                 melody_current_note_duration = audio_duration_to_ms(2);
 
@@ -425,13 +506,14 @@ bool audio_update_state(void) {
 
                 // '- delta': Skip forward in the next note's length if we've over shot
                 //            the last, so the overall length of the song is the same
-                uint16_t duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                uint16_t duration = melody_note_duration(current_note);
 
                 // Skip forward past any completely missed notes
                 while (delta > duration && current_note < notes_count - 1) {
                     delta -= duration;
                     current_note++;
-                    duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                    duration = melody_note_duration(current_note);
+                    pitch    = melody_note_pitch(current_note);
                 }
 
                 if (delta < duration) {
@@ -442,7 +524,8 @@ bool audio_update_state(void) {
                     duration = 1;
                 }
 
-                audio_play_note((*notes_pointer)[current_note][0], duration);
+                audio_play_note_fixed(pitch, duration);
+                melody_current_pitch         = pitch;
                 melody_current_note_duration = duration;
             }
         }
@@ -464,7 +547,7 @@ bool audio_update_state(void) {
                 && (tones[i].duration != 0)    // 'uninitialized'
             ) {
                 if (timer_elapsed(tones[i].time_started) >= tones[i].duration) {
-                    audio_stop_tone(tones[i].pitch);  // also sets 'state_changed=true'
+                    audio_stop_tone_fixed(tones[i].pitch);  // also sets 'state_changed=true'
                 }
             }
         }
@@ -59,11 +59,11 @@ typedef union {
  * "A musical tone is characterized by its duration, pitch, intensity (or loudness), and timbre (or quality)"
  */
 typedef struct {
-    uint16_t time_started;  // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
-    float    pitch;         // aka frequency, in Hz
-    uint16_t duration;      // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
-    // float intensity;    // aka volume [0,1] TODO: not used at the moment; pwm drivers can't handle it
-    // uint8_t timbre;     // range: [0,100] TODO: this currently kept track of globally, should we do this per tone instead?
+    uint16_t     time_started;  // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
+    audio_freq_t pitch;         // aka frequency, in Hz as Q16.16 fixed point
+    uint16_t     duration;      // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
+    // float intensity;        // aka volume [0,1] TODO: not used at the moment; pwm drivers can't handle it
+    // uint8_t timbre;         // range: [0,100] TODO: this currently kept track of globally, should we do this per tone instead?
 } musical_tone_t;
 
 // public interface
@@ -147,6 +147,32 @@ void audio_stop_tone(float pitch);
  */
 void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat);
 
+/**
+ * A melody/SONG compiled by 'qmk generate-audio-songs' into a stream of
+ * records in PROGMEM, each three bytes, or four with COMPILED_NOTE_RUN set:
+ *   [0]    index into note_frequency_lut (0 = rest), ORed with COMPILED_NOTE_RUN
+ *   [1..2] duration in ms at the song's tempo, little endian
+ *   [3]    with COMPILED_NOTE_RUN: how often the note repeats after the first
+ */
+typedef struct {
+    const uint8_t *notes;  // records, in PROGMEM
+    uint16_t       count;  // number of notes, with the runs expanded
+    uint8_t        tempo;  // in beats-per-minute, the durations were computed for
+} compiled_song_t;
+
+#define COMPILED_NOTE_RUN 0x80
+
+/**
+ * @brief plays a compiled melody/SONG
+ * @details same as audio_play_melody, but without any float math per note:
+ *          frequencies come from note_frequency_lut and durations are already
+ *          in ms; only a tempo differing from the one the song was compiled
+ *          with rescales them
+ * @param[in] song: as written by 'qmk generate-audio-songs'
+ * @param[in] n_repeat
+ */
+void audio_play_compiled_melody(const compiled_song_t *song, bool n_repeat);
+
 /**
  * @brief play a short tone of a specific frequency to emulate a 'click'
  *
@@ -193,6 +219,12 @@ bool audio_is_playing_melody(void);
  */
 #define PLAY_LOOP(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), true)
 
+/**
+ * @brief convenience macros, to play a compiled melody/SONG once or in a loop
+ */
+#define PLAY_COMPILED_SONG(song) audio_play_compiled_melody(&song, false)
+#define PLAY_COMPILED_LOOP(song) audio_play_compiled_melody(&song, true)
+
 // Tone-Multiplexing functions
 // this feature only makes sense for hardware setups which can't do proper
 // audio-wave synthesis = have no DAC and need to use PWM for tone generation
@@ -257,6 +289,15 @@ float audio_get_frequency(uint8_t tone_index);
  */
 float audio_get_processed_frequency(uint8_t tone_index);
 
+/**
+ * @brief same as audio_get_processed_frequency, without the float conversion
+ * @details for drivers on MCUs without an FPU; the per-update path through the
+ *          voices is fixed point, so this saves the round trip through float
+ * @param[in] tone_index, see audio_get_processed_frequency
+ * @return a positive frequency, in Hz as Q16.16; or zero if the tone is a pause
+ */
+audio_freq_t audio_get_processed_frequency_fixed(uint8_t tone_index);
+
 /**
  * @brief   update audio internal state: currently playing and active tones,...
  * @details This function is intended to be called by the audio-hardware
@@ -139,10 +139,19 @@ extern uint8_t note_timbre;
 #endif
 // -----------------------------------------------------------------------------
 
+/* Frequencies arrive as Q16.16 fixed point, which keeps the soft-float
+ * routines out of the ISR: the timer period F_CPU / (freq * CPU_PRESCALER)
+ * is computed in Q24.8, and the number of timer overflows between two
+ * audio_update_state calls (freq / (CPU_PRESCALER * 8)) once per frequency
+ * change instead of on every ISR.
+ */
+#define AUDIO_PERIOD(freq) ((((uint32_t)(F_CPU / CPU_PRESCALER)) << 8) / (uint32_t)((freq) >> 8))
+#define AUDIO_UPDATE_DIVIDER(freq) ((uint32_t)((freq) + AUDIO_FREQ(CPU_PRESCALER * 8) - 1) / AUDIO_FREQ(CPU_PRESCALER * 8))
+
 #ifdef AUDIO1_PIN_SET
-static float channel_1_frequency = 0.0f;
-void         channel_1_set_frequency(float freq) {
-    if (freq == 0.0f)  // a pause/rest is a valid "note" with freq=0
+static uint16_t channel_1_update_divider = 0;
+void            channel_1_set_frequency(audio_freq_t freq) {
+    if (freq < AUDIO_FREQ(1))  // a pause/rest is a valid "note" with freq=0
     {
         // disable the output, but keep the pwm-ISR going (with the previous
         // frequency) so the audio-state keeps getting updated
@@ -153,12 +162,13 @@ void         channel_1_set_frequency(float freq) {
         AUDIO1_TCCRxA |= _BV(AUDIO1_COMxy1);  // enable output, PWM mode
     }
 
-    channel_1_frequency = freq;
+    channel_1_update_divider = AUDIO_UPDATE_DIVIDER(freq);
 
+    uint32_t period = AUDIO_PERIOD(freq);
     // set pwm period
-    AUDIO1_ICRx = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+    AUDIO1_ICRx = (uint16_t)period;
     // and duty cycle
-    AUDIO1_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    AUDIO1_OCRxy = (uint16_t)(period * note_timbre / 100);
 }
 
 void channel_1_start(void) {
@@ -177,22 +187,25 @@ void channel_1_stop(void) {
 #endif
 
 #ifdef AUDIO2_PIN_SET
-static float channel_2_frequency = 0.0f;
-void         channel_2_set_frequency(float freq) {
-    if (freq == 0.0f) {
+static audio_freq_t channel_2_frequency      = 0;
+static uint16_t     channel_2_update_divider = 0;
+void                channel_2_set_frequency(audio_freq_t freq) {
+    if (freq < AUDIO_FREQ(1)) {
         AUDIO2_TCCRxA &= ~(_BV(AUDIO2_COMxy1) | _BV(AUDIO2_COMxy0));
         return;
     } else {
         AUDIO2_TCCRxA |= _BV(AUDIO2_COMxy1);
     }
 
-    channel_2_frequency = freq;
+    channel_2_frequency      = freq;
+    channel_2_update_divider = AUDIO_UPDATE_DIVIDER(freq);
 
-    AUDIO2_ICRx  = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-    AUDIO2_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    uint32_t period = AUDIO_PERIOD(freq);
+    AUDIO2_ICRx     = (uint16_t)period;
+    AUDIO2_OCRxy    = (uint16_t)(period * note_timbre / 100);
 }
 
-float channel_2_get_frequency(void) { return channel_2_frequency; }
+audio_freq_t channel_2_get_frequency(void) { return channel_2_frequency; }
 
 void channel_2_start(void) {
     AUDIO2_TIMSKx |= _BV(AUDIO2_OCIExy);
@@ -260,14 +273,14 @@ void audio_driver_start(void) {
 #ifdef AUDIO1_PIN_SET
     channel_1_start();
     if (playing_note) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_frequency_fixed(0));
     }
 #endif
 
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
     channel_2_start();
     if (playing_note) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_frequency_fixed(0));
     }
 #endif
 }
@@ -276,7 +289,7 @@ static volatile uint32_t isr_counter = 0;
 #ifdef AUDIO1_PIN_SET
 ISR(AUDIO1_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_1_frequency / (CPU_PRESCALER * 8)) return;
+    if (isr_counter < channel_1_update_divider) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -290,10 +303,10 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_frequency_fixed(0));
 #    ifdef AUDIO2_PIN_SET
         if (audio_get_number_of_active_tones() > 1) {
-            channel_2_set_frequency(audio_get_processed_frequency(1));
+            channel_2_set_frequency(audio_get_processed_frequency_fixed(1));
         } else {
             channel_2_stop();
         }
@@ -305,7 +318,7 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
 ISR(AUDIO2_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_2_frequency / (CPU_PRESCALER * 8)) return;
+    if (isr_counter < channel_2_update_divider) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -316,7 +329,7 @@ ISR(AUDIO2_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_frequency_fixed(0));
     }
 }
 #endif
@@ -124,3 +124,31 @@
  *user overridable sample generation/processing
  */
 uint16_t dac_value_generate(void);
+
+/**
+ * Wavetables the additive DAC driver can play each voice with; the
+ * AUDIO_DAC_SAMPLE_WAVEFORM_* define selects the one all voices start with.
+ */
+typedef enum {
+    AUDIO_DAC_WAVEFORM_SINE,
+    AUDIO_DAC_WAVEFORM_TRIANGLE,
+    AUDIO_DAC_WAVEFORM_SQUARE,
+    AUDIO_DAC_WAVEFORM_TRAPEZOID,
+    number_of_dac_waveforms  // important that this is last
+} audio_dac_waveform_t;
+
+/**
+ * @brief select the wavetable for one voice of the additive DAC driver
+ * @param[in] voice: ranging from 0 to AUDIO_MAX_SIMULTANEOUS_TONES-1, in the
+ *            order of audio_get_processed_frequency
+ */
+void audio_dac_set_waveform(uint8_t voice, audio_dac_waveform_t waveform);
+
+#ifdef AUDIO_DAC_PROFILE
+/**
+ * @brief time spent in the last/longest DMA half-buffer callback of the
+ *        additive DAC driver, in realtime counter cycles (= core clock cycles on Cortex-M)
+ */
+uint32_t audio_dac_isr_cycles_last(void);
+uint32_t audio_dac_isr_cycles_max(void);
+#endif
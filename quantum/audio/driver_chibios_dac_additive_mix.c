@@ -0,0 +1,175 @@
+/* Copyright 2020 JohSchneider
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audio.h"
+#include "driver_chibios_dac_additive_mix.h"
+#include <string.h>
+
+#if !defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE) && !defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE) && !defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE) && !defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
+#    define AUDIO_DAC_SAMPLE_WAVEFORM_SINE
+#endif
+
+static const dacsample_t dac_buffer_square[AUDIO_DAC_BUFFER_SIZE] = {
+    [0 ... AUDIO_DAC_BUFFER_SIZE / 2 - 1]                     = 0,                     // first and
+    [AUDIO_DAC_BUFFER_SIZE / 2 ... AUDIO_DAC_BUFFER_SIZE - 1] = AUDIO_DAC_SAMPLE_MAX,  // second half
+};
+/*
+// four steps: 0, 1/3, 2/3 and 1
+static const dacsample_t dac_buffer_staircase[AUDIO_DAC_BUFFER_SIZE] = {
+    [0 ... AUDIO_DAC_BUFFER_SIZE/3 -1 ]                               = 0,
+    [AUDIO_DAC_BUFFER_SIZE / 4 ... AUDIO_DAC_BUFFER_SIZE / 2 -1 ]     = AUDIO_DAC_SAMPLE_MAX / 3,
+    [AUDIO_DAC_BUFFER_SIZE / 2 ... 3 * AUDIO_DAC_BUFFER_SIZE / 4 -1 ] = 2 * AUDIO_DAC_SAMPLE_MAX / 3,
+    [3 * AUDIO_DAC_BUFFER_SIZE / 4 ... AUDIO_DAC_BUFFER_SIZE -1 ]     = AUDIO_DAC_SAMPLE_MAX,
+}
+*/
+
+static const dacsample_t *const dac_wavetables[] = {
+    [AUDIO_DAC_WAVEFORM_SINE]      = audio_wavetable_sine,
+    [AUDIO_DAC_WAVEFORM_TRIANGLE]  = audio_wavetable_triangle,
+    [AUDIO_DAC_WAVEFORM_SQUARE]    = dac_buffer_square,
+    [AUDIO_DAC_WAVEFORM_TRAPEZOID] = audio_wavetable_trapezoid,
+};
+
+#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
+#    define AUDIO_DAC_WAVEFORM_DEFAULT AUDIO_DAC_WAVEFORM_TRIANGLE
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
+#    define AUDIO_DAC_WAVEFORM_DEFAULT AUDIO_DAC_WAVEFORM_TRAPEZOID
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
+#    define AUDIO_DAC_WAVEFORM_DEFAULT AUDIO_DAC_WAVEFORM_SQUARE
+#else
+#    define AUDIO_DAC_WAVEFORM_DEFAULT AUDIO_DAC_WAVEFORM_SINE
+#endif
+
+/* Each voice walks its wavetable with a 32bit phase accumulator: the top 8 bits
+ * index the 256 samples, the lower 24 are the fraction; wrapping around the
+ * table is the natural integer overflow.
+ */
+static uint32_t           dac_phase[AUDIO_MAX_SIMULTANEOUS_TONES]       = {0};
+static uint32_t           dac_phase_start[AUDIO_MAX_SIMULTANEOUS_TONES] = {0};
+static uint16_t           dac_phase_start_index                         = 0;
+static const dacsample_t *dac_voice_wavetable[AUDIO_MAX_SIMULTANEOUS_TONES] = {[0 ... AUDIO_MAX_SIMULTANEOUS_TONES - 1] = NULL};
+
+/* phase increments per sample of the currently playing tones */
+static uint32_t active_tones_snapshot[AUDIO_MAX_SIMULTANEOUS_TONES] = {0};
+static uint8_t  active_tones_snapshot_length                        = 0;
+
+/**
+ * Per sample generation of the waveform, for keyboards that bring their own
+ * wave-forms/noises. Deliberately only declared weak: without an implementation
+ * the reference resolves to NULL and the block mixer below is used instead.
+ */
+__attribute__((weak)) uint16_t dac_value_generate(void);
+
+void audio_dac_set_waveform(uint8_t voice, audio_dac_waveform_t waveform) {
+    if (voice < AUDIO_MAX_SIMULTANEOUS_TONES && waveform < number_of_dac_waveforms) {
+        dac_voice_wavetable[voice] = dac_wavetables[waveform];
+    }
+}
+
+/**
+ * Phase increment per sample for a Q16.16 frequency:
+ * freq * AUDIO_DAC_BUFFER_SIZE / AUDIO_DAC_SAMPLE_RATE * 2 / 3 table steps, in 1/2^24 steps
+ *
+ * Note: the 2/3 are necessary to get the correct frequencies on the DAC output
+ *       (as measured with an oscilloscope), since the gpt timer runs with
+ *       3*AUDIO_DAC_SAMPLE_RATE; and the DAC callback is called twice per conversion.
+ */
+uint32_t dac_phase_increment(audio_freq_t freq) { return (uint32_t)(((uint64_t)freq << (8 + 24 + 1 - AUDIO_FREQ_FRACTION_BITS)) / (3 * AUDIO_DAC_SAMPLE_RATE)); }
+
+/**
+ * Additive wave synthesis over all currently playing tones, for the samples
+ * [from, to) of the half buffer: voice by voice, each scaled by the number of
+ * active tones. The cost is bounded by AUDIO_MAX_SIMULTANEOUS_TONES table
+ * lookups and multiply-adds per sample.
+ */
+void dac_mix(dacsample_t *samples, uint16_t from, uint16_t to) {
+    dac_phase_start_index = from;
+
+    if (dac_value_generate) {
+        for (uint16_t s = from; s < to; s++) {
+            samples[s] = dac_value_generate();
+        }
+        return;
+    }
+
+    // DAC is running/asking for values but snapshot length is zero -> must be playing a pause
+    if (active_tones_snapshot_length == 0) {
+        for (uint16_t s = from; s < to; s++) {
+            samples[s] = AUDIO_DAC_OFF_VALUE;
+        }
+        return;
+    }
+
+    uint32_t gain = 0x10000 / active_tones_snapshot_length;
+    for (uint8_t i = 0; i < active_tones_snapshot_length; i++) {
+        const dacsample_t *wavetable = dac_voice_wavetable[i] ? dac_voice_wavetable[i] : dac_wavetables[AUDIO_DAC_WAVEFORM_DEFAULT];
+        uint32_t           phase     = dac_phase[i];
+        uint32_t           increment = active_tones_snapshot[i];
+        dac_phase_start[i]           = phase;
+
+        if (i == 0) {
+            for (uint16_t s = from; s < to; s++, phase += increment) {
+                samples[s] = (wavetable[phase >> 24] * gain) >> 16;
+            }
+        } else {
+            for (uint16_t s = from; s < to; s++, phase += increment) {
+                samples[s] += (wavetable[phase >> 24] * gain) >> 16;
+            }
+        }
+        dac_phase[i] = phase;
+    }
+}
+
+/**
+ * Takes a new snapshot of the active tones, for the samples after 'index'.
+ * Should the tones have changed, the phases are wound back to 'index' and the
+ * rest of the half buffer is generated again with the new set of tones; by
+ * dac_value_generate too, which gets to see the change at the same sample.
+ */
+void dac_update_snapshot(dacsample_t *samples, uint16_t index) {
+    uint8_t  active_tones = MIN(AUDIO_MAX_SIMULTANEOUS_TONES, audio_get_number_of_active_tones());
+    uint32_t increments[AUDIO_MAX_SIMULTANEOUS_TONES];
+    uint8_t  length = 0;
+
+    for (uint8_t i = 0; i < active_tones; i++) {
+        audio_freq_t freq = audio_get_processed_frequency_fixed(i);
+        if (freq > 0) {  // disregard 'rest' notes, with valid frequency 0; which would only lower the resulting waveform volume during the additive synthesis step
+            increments[length++] = dac_phase_increment(freq);
+        }
+    }
+
+    if (length == active_tones_snapshot_length && memcmp(increments, active_tones_snapshot, length * sizeof(uint32_t)) == 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < active_tones_snapshot_length; i++) {
+        dac_phase[i] = dac_phase_start[i] + (index + 1 - dac_phase_start_index) * active_tones_snapshot[i];
+    }
+    memcpy(active_tones_snapshot, increments, length * sizeof(uint32_t));
+    active_tones_snapshot_length = length;
+
+    dac_mix(samples, index + 1, AUDIO_DAC_BUFFER_SIZE / 2);
+}
+
+uint8_t dac_snapshot_length(void) { return active_tones_snapshot_length; }
+
+void dac_mix_reset(void) {
+    for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
+        dac_phase[i]             = 0;
+        active_tones_snapshot[i] = 0;
+    }
+    active_tones_snapshot_length = 0;
+}
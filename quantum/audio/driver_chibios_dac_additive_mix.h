@@ -0,0 +1,60 @@
+/* Copyright 2020 JohSchneider
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "musical_notes.h"
+#include "driver_chibios_dac.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <hal.h>
+#else
+// as the STM32 DAC driver has it, for building the mixer on the host
+typedef uint16_t dacsample_t;
+#endif
+
+/**
+ * The sample generation of the additive DAC driver, which needs none of its
+ * hardware: the driver hands it one half of the DMA buffer at a time.
+ */
+
+/**
+ * @brief phase increment per sample of a voice playing a Q16.16 frequency
+ */
+uint32_t dac_phase_increment(audio_freq_t freq);
+
+/**
+ * @brief mix the currently playing tones into the samples [from, to) of a half buffer
+ */
+void dac_mix(dacsample_t *samples, uint16_t from, uint16_t to);
+
+/**
+ * @brief take a new snapshot of the playing tones, starting after the sample 'index'
+ *
+ * Should the tones have changed, the phases are wound back to 'index' and the
+ * rest of the half buffer is generated again.
+ */
+void dac_update_snapshot(dacsample_t *samples, uint16_t index);
+
+/**
+ * @brief number of tones in the current snapshot, without 'rest' notes
+ */
+uint8_t dac_snapshot_length(void);
+
+/**
+ * @brief silence all voices and start their phases over
+ */
+void dac_mix_reset(void);
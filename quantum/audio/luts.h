@@ -16,18 +16,34 @@
 
 #pragma once
 
+#include <stdint.h>
 #if defined(__AVR__)
 #    include <avr/io.h>
 #    include <avr/interrupt.h>
 #    include <avr/pgmspace.h>
-#else
+#elif defined(PROTOCOL_CHIBIOS)
 #    include <ch.h>
 #    include <hal.h>
 #endif
+#include "musical_notes.h"
 
 #define VIBRATO_LUT_LENGTH 20
 
 #define FREQUENCY_LUT_LENGTH 349
 
-extern const float    vibrato_lut[VIBRATO_LUT_LENGTH];
+// NOTE_REST, followed by NOTE_C0 to NOTE_B8
+#define NOTE_FREQUENCY_LUT_LENGTH (1 + 9 * 12)
+
+// deviation of the frequency factor from 1.0, in 1/65536 steps
+extern const int16_t  vibrato_lut[VIBRATO_LUT_LENGTH];
 extern const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH];
+// in PROGMEM
+extern const audio_freq_t note_frequency_lut[NOTE_FREQUENCY_LUT_LENGTH];
+
+#ifdef AUDIO_DRIVER_DAC
+#    define AUDIO_WAVETABLE_LENGTH 256
+
+extern const uint16_t audio_wavetable_sine[AUDIO_WAVETABLE_LENGTH];
+extern const uint16_t audio_wavetable_triangle[AUDIO_WAVETABLE_LENGTH];
+extern const uint16_t audio_wavetable_trapezoid[AUDIO_WAVETABLE_LENGTH];
+#endif
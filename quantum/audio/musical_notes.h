@@ -16,6 +16,18 @@
  */
 #pragma once
 
+#include <stdint.h>
+
+/* Past the float based API (SONG arrays, audio_play_note, ...) frequencies are
+ * kept as signed Q16.16 fixed point Hz, so that the per-update path through
+ * audio.c, voices.c and the drivers needs no floating point math.
+ */
+typedef int32_t audio_freq_t;
+
+#define AUDIO_FREQ_FRACTION_BITS 16
+#define AUDIO_FREQ(hz) ((audio_freq_t)((hz) * (1L << AUDIO_FREQ_FRACTION_BITS)))
+#define AUDIO_FREQ_TO_FLOAT(freq) ((float)(freq) / (1L << AUDIO_FREQ_FRACTION_BITS))
+
 #ifndef TEMPO_DEFAULT
 #    define TEMPO_DEFAULT 120
 // in beats-per-minute
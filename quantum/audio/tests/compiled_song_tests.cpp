@@ -0,0 +1,132 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "audio.h"
+
+extern audio_freq_t melody_current_pitch;
+extern uint16_t     melody_current_note_duration;
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// no hardware behind the audio system here
+void audio_driver_initialize(void) {}
+void audio_driver_start(void) {}
+void audio_driver_stop(void) {}
+void eeconfig_update_audio(uint8_t val) {}
+void audio_on_user(void) {}
+}
+
+typedef std::vector<std::pair<audio_freq_t, uint16_t>> trace_t;
+
+/* Steps the playing melody through time 1ms at a time, recording the pitch
+ * and duration of the current note at each step.
+ */
+static trace_t play_trace(uint32_t ms) {
+    trace_t trace;
+    for (uint32_t t = 0; t < ms && audio_is_playing_melody(); t++) {
+        audio_update_state();
+        trace.push_back({melody_current_pitch, melody_current_note_duration});
+        advance_time(1);
+    }
+    return trace;
+}
+
+// clang-format off
+static float song[][2] = SONG(
+    Q__NOTE(_C4), Q__NOTE(_C4), Q__NOTE(_C4),
+    E__NOTE(_REST),
+    H__NOTE(_E4),
+    S__NOTE(_G4), S__NOTE(_G4)
+);
+
+// what 'qmk generate-audio-songs -r' makes of it at 120 bpm: a run of three C4,
+// a rest, E4 and a run of two G4, with the durations in ms
+static const uint8_t PROGMEM song_notes[] = {
+    49 | COMPILED_NOTE_RUN, 0x7D, 0x00, 2,
+    0, 0x3E, 0x00,
+    53, 0xFA, 0x00,
+    56 | COMPILED_NOTE_RUN, 0x1F, 0x00, 1,
+};
+static const compiled_song_t compiled_song_120 = {song_notes, 7, 120};
+
+static const uint8_t PROGMEM long_note[] = {
+    49, 0xFF, 0xFF,
+};
+static const compiled_song_t compiled_long_note = {long_note, 1, 120};
+// clang-format on
+
+class CompiledSong : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        audio_init();
+        audio_set_tempo(120);
+        set_time(0);
+    }
+
+    void TearDown() override {
+        audio_stop_all();
+        audio_set_tempo(TEMPO_DEFAULT);
+    }
+};
+
+TEST_F(CompiledSong, PlaysLikeTheSong) {
+    PLAY_SONG(song);
+    trace_t expected = play_trace(5000);
+    ASSERT_FALSE(audio_is_playing_melody());
+    // three quarters, an eighth, a half and two sixteenths
+    ASSERT_GE(expected.size(), 3 * 125 + 62 + 250 + 2 * 31);
+
+    set_time(0);
+    PLAY_COMPILED_SONG(compiled_song_120);
+    trace_t compiled = play_trace(5000);
+    EXPECT_FALSE(audio_is_playing_melody());
+
+    EXPECT_EQ(compiled, expected);
+}
+
+TEST_F(CompiledSong, LoopsLikeTheSong) {
+    // three rounds, so the run of C4 is sought again from the start each time
+    PLAY_LOOP(song);
+    trace_t expected = play_trace(2000);
+
+    set_time(0);
+    PLAY_COMPILED_LOOP(compiled_song_120);
+    trace_t compiled = play_trace(2000);
+
+    EXPECT_EQ(compiled, expected);
+}
+
+TEST_F(CompiledSong, RescalesToTheTempo) {
+    audio_set_tempo(60);
+    PLAY_COMPILED_SONG(compiled_song_120);
+    EXPECT_EQ(melody_current_note_duration, 250);
+
+    audio_set_tempo(240);
+    PLAY_COMPILED_SONG(compiled_song_120);
+    EXPECT_EQ(melody_current_note_duration, 62);
+}
+
+TEST_F(CompiledSong, SlowedDownNotesAreClamped) {
+    audio_set_tempo(60);
+    PLAY_COMPILED_SONG(compiled_long_note);
+    EXPECT_EQ(melody_current_note_duration, UINT16_MAX);
+}
@@ -0,0 +1,234 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <string.h>
+
+extern "C" {
+#include "driver_chibios_dac_additive_mix.h"
+#include "luts.h"
+}
+
+#define HALF_BUFFER (AUDIO_DAC_BUFFER_SIZE / 2)
+
+// The tones audio.c would be playing
+static audio_freq_t playing[AUDIO_MAX_SIMULTANEOUS_TONES];
+static uint8_t      playing_count;
+
+extern "C" uint8_t audio_get_number_of_active_tones(void) { return playing_count; }
+
+extern "C" audio_freq_t audio_get_processed_frequency_fixed(uint8_t tone_index) { return playing[tone_index]; }
+
+class DacAdditiveMix : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        playing_count = 0;
+        dac_mix_reset();
+        for (uint8_t voice = 0; voice < AUDIO_MAX_SIMULTANEOUS_TONES; voice++) {
+            audio_dac_set_waveform(voice, AUDIO_DAC_WAVEFORM_SINE);
+        }
+    }
+
+    void play(audio_freq_t a) {
+        playing[0]    = a;
+        playing_count = 1;
+    }
+
+    void play(audio_freq_t a, audio_freq_t b) {
+        playing[0]    = a;
+        playing[1]    = b;
+        playing_count = 2;
+    }
+
+    // As the driver starts: a block of silence, and the tones from the zero crossing at its first sample on
+    void start(void) {
+        dac_mix(block, 0, HALF_BUFFER);
+        dac_update_snapshot(block, 0);
+    }
+
+    void next_block(void) { dac_mix(block, 0, HALF_BUFFER); }
+
+    dacsample_t block[HALF_BUFFER];
+};
+
+// One voice out of 'voices' at the given phase, the top 8 bits indexing the wavetable
+static uint16_t voice_sample(const uint16_t* wavetable, uint32_t phase, uint8_t voices) { return (wavetable[phase >> 24] * (0x10000 / voices)) >> 16; }
+
+#ifndef TEST_DAC_VALUE_GENERATE
+
+TEST_F(DacAdditiveMix, PhaseIncrementMatchesTheFrequency) {
+    // the gpt timer runs at three times the sample rate, and the callback comes twice per conversion
+    double expected = 440.0 * AUDIO_WAVETABLE_LENGTH * (1UL << 24) * 2 / (3.0 * AUDIO_DAC_SAMPLE_RATE);
+    EXPECT_NEAR(dac_phase_increment(AUDIO_FREQ(440)), expected, 1);
+    EXPECT_EQ(dac_phase_increment(0), 0);
+}
+
+TEST_F(DacAdditiveMix, PausesAndRestsAreSilent) {
+    start();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], AUDIO_DAC_OFF_VALUE) << "at sample " << s;
+    }
+
+    // a rest note is no tone at all, rather than one that lowers the volume of the others
+    play(0);
+    dac_update_snapshot(block, 0);
+    EXPECT_EQ(dac_snapshot_length(), 0);
+    next_block();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], AUDIO_DAC_OFF_VALUE) << "at sample " << s;
+    }
+}
+
+TEST_F(DacAdditiveMix, OneToneWalksItsWavetableAcrossBlocks) {
+    uint32_t increment = dac_phase_increment(AUDIO_FREQ(440));
+    play(AUDIO_FREQ(440));
+    start();
+    EXPECT_EQ(dac_snapshot_length(), 1);
+    EXPECT_EQ(block[0], AUDIO_DAC_OFF_VALUE);
+    for (uint16_t s = 1; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], audio_wavetable_sine[((s - 1) * increment) >> 24]) << "at sample " << s;
+    }
+
+    next_block();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], audio_wavetable_sine[((HALF_BUFFER - 1 + s) * increment) >> 24]) << "at sample " << s;
+    }
+}
+
+TEST_F(DacAdditiveMix, VoicesPlayTheirOwnWaveforms) {
+    uint32_t a = dac_phase_increment(AUDIO_FREQ(440));
+    uint32_t b = dac_phase_increment(AUDIO_FREQ(660));
+    audio_dac_set_waveform(0, AUDIO_DAC_WAVEFORM_TRIANGLE);
+    audio_dac_set_waveform(1, AUDIO_DAC_WAVEFORM_TRAPEZOID);
+    play(AUDIO_FREQ(440), AUDIO_FREQ(660));
+    start();
+    next_block();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        uint32_t n = HALF_BUFFER - 1 + s;
+        ASSERT_EQ(block[s], voice_sample(audio_wavetable_triangle, n * a, 2) + voice_sample(audio_wavetable_trapezoid, n * b, 2)) << "at sample " << s;
+    }
+}
+
+TEST_F(DacAdditiveMix, SquareWaveformOnlyHasTwoLevels) {
+    audio_dac_set_waveform(0, AUDIO_DAC_WAVEFORM_SQUARE);
+    play(AUDIO_FREQ(440));
+    start();
+    next_block();
+    uint16_t highs = 0;
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_TRUE(block[s] == 0 || block[s] == AUDIO_DAC_SAMPLE_MAX) << "at sample " << s;
+        highs += block[s] == AUDIO_DAC_SAMPLE_MAX;
+    }
+    EXPECT_GT(highs, 0);
+    EXPECT_LT(highs, HALF_BUFFER);
+}
+
+TEST_F(DacAdditiveMix, InvalidVoicesAndWaveformsAreIgnored) {
+    uint32_t increment = dac_phase_increment(AUDIO_FREQ(440));
+    audio_dac_set_waveform(0, number_of_dac_waveforms);
+    audio_dac_set_waveform(AUDIO_MAX_SIMULTANEOUS_TONES, AUDIO_DAC_WAVEFORM_TRIANGLE);
+    play(AUDIO_FREQ(440));
+    start();
+    for (uint16_t s = 1; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], audio_wavetable_sine[((s - 1) * increment) >> 24]) << "at sample " << s;
+    }
+}
+
+TEST_F(DacAdditiveMix, UnchangedTonesLeaveTheBlockAlone) {
+    play(AUDIO_FREQ(440), AUDIO_FREQ(660));
+    start();
+    next_block();
+
+    dacsample_t mixed[HALF_BUFFER];
+    memcpy(mixed, block, sizeof(block));
+    dac_update_snapshot(block, 100);
+    EXPECT_EQ(memcmp(mixed, block, sizeof(block)), 0);
+}
+
+TEST_F(DacAdditiveMix, ToneChangedMidBlockIsRemixedFromTheChange) {
+    uint32_t a      = dac_phase_increment(AUDIO_FREQ(440));
+    uint32_t b      = dac_phase_increment(AUDIO_FREQ(660));
+    uint32_t b_new  = dac_phase_increment(AUDIO_FREQ(880));
+    uint32_t change = HALF_BUFFER - 1 + 101;  // the sample after the zero crossing, counted from the start
+
+    // the second tone is wound back to where the first sample after the change
+    // should be, and carries on from there at its new pitch
+    auto expected = [&](uint32_t n) {
+        uint32_t phase_b = n < change ? n * b : change * b + (n - change) * b_new;
+        return voice_sample(audio_wavetable_sine, n * a, 2) + voice_sample(audio_wavetable_sine, phase_b, 2);
+    };
+
+    play(AUDIO_FREQ(440), AUDIO_FREQ(660));
+    start();
+    next_block();
+    play(AUDIO_FREQ(440), AUDIO_FREQ(880));
+    dac_update_snapshot(block, 100);
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], expected(HALF_BUFFER - 1 + s)) << "at sample " << s;
+    }
+
+    next_block();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], expected(2 * HALF_BUFFER - 1 + s)) << "at sample " << s << " of the next block";
+    }
+}
+
+TEST_F(DacAdditiveMix, ToneStoppedMidBlockLeavesTheOtherAtFullGain) {
+    uint32_t a = dac_phase_increment(AUDIO_FREQ(440));
+    uint32_t b = dac_phase_increment(AUDIO_FREQ(660));
+    play(AUDIO_FREQ(440), AUDIO_FREQ(660));
+    start();
+    next_block();
+    play(AUDIO_FREQ(440));
+    dac_update_snapshot(block, 50);
+    EXPECT_EQ(dac_snapshot_length(), 1);
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        uint32_t n = HALF_BUFFER - 1 + s;
+        if (s <= 50) {
+            ASSERT_EQ(block[s], voice_sample(audio_wavetable_sine, n * a, 2) + voice_sample(audio_wavetable_sine, n * b, 2)) << "at sample " << s;
+        } else {
+            ASSERT_EQ(block[s], voice_sample(audio_wavetable_sine, n * a, 1)) << "at sample " << s;
+        }
+    }
+}
+
+#else
+
+// Numbers its samples, and tells by the thousands how many tones it was generated for
+static uint16_t generated;
+
+extern "C" uint16_t dac_value_generate(void) { return playing_count * 1000 + generated++; }
+
+TEST_F(DacAdditiveMix, GeneratedBlockIsRedoneAfterAToneChange) {
+    generated = 0;
+    play(AUDIO_FREQ(440));
+    next_block();
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        ASSERT_EQ(block[s], 1000 + s) << "at sample " << s;
+    }
+
+    play(AUDIO_FREQ(440), AUDIO_FREQ(660));
+    dac_update_snapshot(block, 50);
+    for (uint16_t s = 0; s < HALF_BUFFER; s++) {
+        if (s <= 50) {
+            ASSERT_EQ(block[s], 1000 + s) << "at sample " << s;
+        } else {
+            ASSERT_EQ(block[s], 2000 + HALF_BUFFER + s - 51) << "at sample " << s;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,26 @@
+voices_DEFS := -DAUDIO_VOICES -DMATRIX_ROWS=1 -DMATRIX_COLS=1
+
+voices_SRC := \
+	$(QUANTUM_PATH)/audio/tests/voices_tests.cpp \
+	$(QUANTUM_PATH)/audio/voices.c \
+	$(QUANTUM_PATH)/audio/luts.c \
+	$(TMK_PATH)/common/test/timer.c
+
+compiled_song_DEFS := -DAUDIO_ENABLE -DMATRIX_ROWS=1 -DMATRIX_COLS=1
+
+compiled_song_SRC := \
+	$(QUANTUM_PATH)/audio/tests/compiled_song_tests.cpp \
+	$(QUANTUM_PATH)/audio/audio.c \
+	$(QUANTUM_PATH)/audio/voices.c \
+	$(QUANTUM_PATH)/audio/luts.c \
+	$(TMK_PATH)/common/test/timer.c
+
+dac_additive_mix_DEFS := -DAUDIO_ENABLE -DAUDIO_DRIVER_DAC -DMATRIX_ROWS=1 -DMATRIX_COLS=1
+
+dac_additive_mix_SRC := \
+	$(QUANTUM_PATH)/audio/tests/dac_additive_mix_tests.cpp \
+	$(QUANTUM_PATH)/audio/driver_chibios_dac_additive_mix.c \
+	$(QUANTUM_PATH)/audio/luts.c
+
+dac_additive_mix_generate_DEFS := $(dac_additive_mix_DEFS) -DTEST_DAC_VALUE_GENERATE
+dac_additive_mix_generate_SRC := $(dac_additive_mix_SRC)
@@ -0,0 +1,5 @@
+TEST_LIST +=\
+	voices\
+	compiled_song\
+	dac_additive_mix\
+	dac_additive_mix_generate
@@ -0,0 +1,284 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+
+extern "C" {
+#include "voices.h"
+#include "timer.h"
+
+extern uint8_t    note_timbre;
+extern bool       glissando;
+extern bool       vibrato;
+extern uint16_t   voices_timer;
+extern voice_type voice;
+
+void set_time(uint32_t t);
+}
+
+/* The float implementation the fixed point voices replaced, kept as the
+ * reference the presets have to match.
+ */
+static const float reference_vibrato_lut[VIBRATO_LUT_LENGTH] = {
+    1.0022336811487, 1.0042529943610, 1.0058584256028, 1.0068905285205, 1.0072464122237, 1.0068905285205, 1.0058584256028, 1.0042529943610, 1.0022336811487, 1.0000000000000, 0.9977712970630, 0.9957650169978, 0.9941756956510, 0.9931566259436, 0.9928057204913, 0.9931566259436, 0.9941756956510, 0.9957650169978, 0.9977712970630, 1.0000000000000,
+};
+
+struct reference_state {
+    uint8_t timbre;
+    bool    vibrato;
+};
+
+static float reference_envelope(voice_type v, uint16_t envelope_index, uint16_t now, float frequency, reference_state* state) {
+    uint16_t compensated_index = envelope_index / 100;
+
+    switch (v) {
+        case vibrating:
+            state->vibrato = true;
+            break;
+
+        case something:
+            switch (compensated_index) {
+                case 0 ... 9:
+                    state->timbre = TIMBRE_12;
+                    break;
+                case 10 ... 19:
+                    state->timbre = TIMBRE_25;
+                    break;
+                case 20 ... 200:
+                    state->timbre = 12 + 12;
+                    break;
+                default:
+                    state->timbre = 12;
+                    break;
+            }
+            break;
+
+        case drums:
+            if (frequency < 80.0) {
+            } else if (frequency < 160.0) {
+                frequency = (rand() % (int)(40)) + 60;
+                switch (envelope_index) {
+                    case 0 ... 10:
+                        state->timbre = 50;
+                        break;
+                    case 11 ... 20:
+                        state->timbre = 50 * (21 - envelope_index) / 10;
+                        break;
+                    default:
+                        state->timbre = 0;
+                        break;
+                }
+            } else if (frequency < 320.0) {
+                frequency = (rand() % (int)(1000)) + 1000;
+                switch (envelope_index) {
+                    case 0 ... 5:
+                        state->timbre = 50;
+                        break;
+                    case 6 ... 20:
+                        state->timbre = 50 * (21 - envelope_index) / 15;
+                        break;
+                    default:
+                        state->timbre = 0;
+                        break;
+                }
+            } else if (frequency < 640.0) {
+                frequency = (rand() % (int)(2000)) + 3000;
+                switch (envelope_index) {
+                    case 0 ... 15:
+                        state->timbre = 50;
+                        break;
+                    case 16 ... 20:
+                        state->timbre = 50 * (21 - envelope_index) / 5;
+                        break;
+                    default:
+                        state->timbre = 0;
+                        break;
+                }
+            } else if (frequency < 1280.0) {
+                frequency = (rand() % (int)(2000)) + 3000;
+                switch (envelope_index) {
+                    case 0 ... 35:
+                        state->timbre = 50;
+                        break;
+                    case 36 ... 50:
+                        state->timbre = 50 * (51 - envelope_index) / 15;
+                        break;
+                    default:
+                        state->timbre = 0;
+                        break;
+                }
+            }
+            break;
+
+        case butts_fader:
+            switch (compensated_index) {
+                case 0 ... 9:
+                    frequency     = frequency / 4;
+                    state->timbre = TIMBRE_12;
+                    break;
+                case 10 ... 19:
+                    frequency     = frequency / 2;
+                    state->timbre = TIMBRE_12;
+                    break;
+                case 20 ... 200:
+                    state->timbre = 12 - (uint8_t)(pow(((float)compensated_index - 20) / (200 - 20), 2) * 12.5);
+                    break;
+                default:
+                    state->timbre = 0;
+                    break;
+            }
+            break;
+
+        case duty_osc:
+            state->timbre = (uint8_t)abs((compensated_index * 10 % 3000) - 1500) * (.25 / 1500) + (1 - .25) / 2;
+            break;
+
+        case duty_octave_down:
+            state->timbre = (uint8_t)(100 * (envelope_index % 2) * .125 + .375 * 2);
+            if ((envelope_index % 4) == 0) state->timbre = 50;
+            if ((envelope_index % 8) == 0) state->timbre = 0;
+            break;
+
+        case delayed_vibrato:
+            state->timbre = TIMBRE_50;
+            if (compensated_index > 150) {
+                frequency = frequency * reference_vibrato_lut[(int)fmod((((float)compensated_index - 151) / 1000 * 50), VIBRATO_LUT_LENGTH)];
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (state->vibrato) {
+        float vibrato_counter = fmod(now / (100 * 0.125), VIBRATO_LUT_LENGTH);
+        frequency             = frequency * pow(reference_vibrato_lut[(int)vibrato_counter], 0.5);
+    }
+
+    return frequency;
+}
+
+static const float test_frequencies[] = {65.41, 98.0, 130.81, 261.63, 440.0, 523.25, 1046.5, 2093.0, 4186.01};
+
+class Voices : public testing::Test {
+   public:
+    Voices() { reset(); }
+
+    void reset(void) {
+        set_time(0);
+        voices_timer = 0;
+        vibrato      = false;
+        glissando    = false;
+        note_timbre  = TIMBRE_DEFAULT;
+    }
+
+    // The vibrato settings are the voices' globals, put back to their defaults even after a failure
+    void TearDown() override {
+        voice_set_vibrato_strength(0.5);
+        voice_set_vibrato_rate(0.125);
+    }
+
+    // Runs a note through 'v' for 'duration' ms, checking every update against the float reference
+    void expect_matches_reference(voice_type v, float frequency, uint32_t duration) {
+        reference_state state = {TIMBRE_DEFAULT, false};
+        set_voice(v);
+        for (uint32_t t = 0; t < duration; t++) {
+            set_time(t);
+            srand(t);
+            float fixed = AUDIO_FREQ_TO_FLOAT(voice_envelope(AUDIO_FREQ(frequency)));
+            srand(t);
+            float reference = reference_envelope(v, t, t, frequency, &state);
+
+            ASSERT_NEAR(fixed, reference, reference * 0.0002 + 0.001) << "voice " << v << " at " << frequency << "Hz, t=" << t;
+            ASSERT_EQ(note_timbre, state.timbre) << "voice " << v << " at " << frequency << "Hz, t=" << t;
+        }
+    }
+};
+
+TEST_F(Voices, every_preset_matches_the_float_reference) {
+    for (int v = default_voice; v < number_of_voices; v++) {
+        for (float frequency : test_frequencies) {
+            reset();
+            expect_matches_reference((voice_type)v, frequency, 25000);
+        }
+    }
+}
+
+TEST_F(Voices, vibrato_stays_within_a_fraction_of_a_cent_of_the_float_reference) {
+    set_voice(vibrating);
+    float max_error_cents = 0;
+    for (uint32_t t = 0; t < 1000; t++) {
+        set_time(t);
+        float fixed     = AUDIO_FREQ_TO_FLOAT(voice_envelope(AUDIO_FREQ(440.0)));
+        float reference = 440.0 * pow(reference_vibrato_lut[(int)fmod(t / 12.5, VIBRATO_LUT_LENGTH)], 0.5);
+        max_error_cents = fmax(max_error_cents, fabs(1200 * log2(fixed / reference)));
+    }
+    RecordProperty("max_error_millicents", (int)(max_error_cents * 1000));
+    EXPECT_LT(max_error_cents, 0.1);
+}
+
+TEST_F(Voices, vibrato_setters_change_rate_and_depth) {
+    set_voice(vibrating);
+    voice_set_vibrato_strength(1.0);
+    voice_set_vibrato_rate(0.5);
+    for (uint32_t t = 0; t < 1000; t++) {
+        set_time(t);
+        float fixed     = AUDIO_FREQ_TO_FLOAT(voice_envelope(AUDIO_FREQ(440.0)));
+        float reference = 440.0 * reference_vibrato_lut[(t / 50) % VIBRATO_LUT_LENGTH];
+        ASSERT_NEAR(fixed, reference, 0.01) << "t=" << t;
+    }
+}
+
+TEST_F(Voices, pause_stays_silent) {
+    for (int v = default_voice; v < number_of_voices; v++) {
+        set_voice((voice_type)v);
+        for (uint32_t t = 0; t < 25000; t += 7) {
+            set_time(t);
+            ASSERT_EQ(voice_envelope(0), 0) << "voice " << v << " t=" << t;
+        }
+    }
+}
+
+TEST_F(Voices, update_cost_against_the_float_reference) {
+    const int iterations = 200000;
+    set_voice(delayed_vibrato);
+    vibrato = true;
+
+    volatile audio_freq_t fixed_sink = 0;
+    auto                  start      = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        set_time(i);
+        fixed_sink = voice_envelope(AUDIO_FREQ(440.0) + i % 16);
+    }
+    auto fixed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    reference_state state          = {TIMBRE_DEFAULT, true};
+    volatile float  reference_sink = 0;
+    start                          = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        reference_sink = reference_envelope(delayed_vibrato, i, i, 440.0 + (i % 16) / 65536.0f, &state);
+    }
+    auto reference_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Host FPUs hide most of the difference; on AVR every float operation here is a soft-float call
+    RecordProperty("fixed_ns_per_update", (int)(fixed_ns / iterations));
+    RecordProperty("float_ns_per_update", (int)(reference_ns / iterations));
+    (void)fixed_sink;
+    (void)reference_sink;
+}
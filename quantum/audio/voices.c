@@ -18,11 +18,16 @@
 #include "audio.h"
 #include <stdlib.h>
 
-uint8_t note_timbre      = TIMBRE_DEFAULT;
-bool    glissando        = false;
-bool    vibrato          = false;
-float   vibrato_strength = 0.5;
-float   vibrato_rate     = 0.125;
+uint8_t note_timbre = TIMBRE_DEFAULT;
+bool    glissando   = false;
+bool    vibrato     = false;
+
+/* Vibrato parameters in Q8.8 fixed point: the strength scales the lut
+ * deviation (0.5), the period is the time spent on each lut entry in ms
+ * (100 * 0.125 rate).
+ */
+static uint16_t vibrato_strength = 128;
+static uint32_t vibrato_period   = 3200;
 
 uint16_t voices_timer = 0;
 
@@ -39,31 +44,41 @@ void voice_iterate() { voice = (voice + 1) % number_of_voices; }
 void voice_deiterate() { voice = (voice - 1 + number_of_voices) % number_of_voices; }
 
 #ifdef AUDIO_VOICES
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
+// Scales 'freq' by (1 + deviation / 65536), without overflowing for audible frequencies
+static audio_freq_t voice_scale_frequency(audio_freq_t freq, int32_t deviation) { return freq + (((freq >> 12) * deviation) >> 4); }
 
 // Effect: 'vibrate' a given target frequency slightly above/below its initial value
-float voice_add_vibrato(float average_freq) {
-    float vibrato_counter = mod(timer_read() / (100 * vibrato_rate), VIBRATO_LUT_LENGTH);
+audio_freq_t voice_add_vibrato(audio_freq_t average_freq) {
+    uint8_t vibrato_counter = (((uint32_t)timer_read() << 8) / vibrato_period) % VIBRATO_LUT_LENGTH;
+
+    // (1 + d)^strength, to first order
+    return voice_scale_frequency(average_freq, ((int32_t)vibrato_lut[vibrato_counter] * vibrato_strength) >> 8);
+}
+
+/* One glissando step is a quarter tone at 440Hz: f * 2^(440 / f / 24), which
+ * expands to f + K + K^2 / 2f + ... with K = ln(2) * 440 / 24 Hz.
+ */
+#    define GLISSANDO_STEP AUDIO_FREQ(12.7076)
+#    define GLISSANDO_STEP_SQUARED_HALF_Q8 20670  // K^2 / 2 in Q24.8
 
-    return average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
+static audio_freq_t voice_glissando_correction(audio_freq_t freq) {
+    audio_freq_t freq_q8 = freq >> 8;
+    return freq_q8 > 0 ? ((audio_freq_t)GLISSANDO_STEP_SQUARED_HALF_Q8 << 16) / freq_q8 : 0;
 }
 
 // Effect: 'slides' the 'frequency' from the starting-point, to the target frequency
-float voice_add_glissando(float from_freq, float to_freq) {
-    if (to_freq != 0 && from_freq < to_freq && from_freq < to_freq * pow(2, -440 / to_freq / 12 / 2)) {
-        return from_freq * pow(2, 440 / from_freq / 12 / 2);
-    } else if (to_freq != 0 && from_freq > to_freq && from_freq > to_freq * pow(2, 440 / to_freq / 12 / 2)) {
-        return from_freq * pow(2, -440 / from_freq / 12 / 2);
+audio_freq_t voice_add_glissando(audio_freq_t from_freq, audio_freq_t to_freq) {
+    if (to_freq != 0 && from_freq < to_freq && from_freq < to_freq - GLISSANDO_STEP + voice_glissando_correction(to_freq)) {
+        return from_freq + GLISSANDO_STEP + voice_glissando_correction(from_freq);
+    } else if (to_freq != 0 && from_freq > to_freq && from_freq > to_freq + GLISSANDO_STEP + voice_glissando_correction(to_freq)) {
+        return from_freq - GLISSANDO_STEP + voice_glissando_correction(from_freq);
     } else {
         return to_freq;
     }
 }
 #endif
 
-float voice_envelope(float frequency) {
+audio_freq_t voice_envelope(audio_freq_t frequency) {
     // envelope_index ranges from 0 to 0xFFFF, which is preserved at 880.0 Hz
 //    __attribute__((unused)) uint16_t compensated_index = (uint16_t)((float)envelope_index * (880.0 / frequency));
 #ifdef AUDIO_VOICES
@@ -120,10 +135,10 @@ float voice_envelope(float frequency) {
             // }
             // frequency = (rand() % (int)(frequency * 1.2 - frequency)) + (frequency * 0.8);
 
-            if (frequency < 80.0) {
-            } else if (frequency < 160.0) {
+            if (frequency < AUDIO_FREQ(80)) {
+            } else if (frequency < AUDIO_FREQ(160)) {
                 // Bass drum: 60 - 100 Hz
-                frequency = (rand() % (int)(40)) + 60;
+                frequency = AUDIO_FREQ(rand() % 40 + 60);
                 switch (envelope_index) {
                     case 0 ... 10:
                         note_timbre = 50;
@@ -136,9 +151,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 320.0) {
+            } else if (frequency < AUDIO_FREQ(320)) {
                 // Snare drum: 1 - 2 KHz
-                frequency = (rand() % (int)(1000)) + 1000;
+                frequency = AUDIO_FREQ(rand() % 1000 + 1000);
                 switch (envelope_index) {
                     case 0 ... 5:
                         note_timbre = 50;
@@ -151,9 +166,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 640.0) {
+            } else if (frequency < AUDIO_FREQ(640)) {
                 // Closed Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = AUDIO_FREQ(rand() % 2000 + 3000);
                 switch (envelope_index) {
                     case 0 ... 15:
                         note_timbre = 50;
@@ -166,9 +181,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 1280.0) {
+            } else if (frequency < AUDIO_FREQ(1280)) {
                 // Open Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = AUDIO_FREQ(rand() % 2000 + 3000);
                 switch (envelope_index) {
                     case 0 ... 35:
                         note_timbre = 50;
@@ -196,7 +211,7 @@ float voice_envelope(float frequency) {
                     break;
 
                 case 20 ... 200:
-                    note_timbre = 12 - (uint8_t)(pow(((float)compensated_index - 20) / (200 - 20), 2) * 12.5);
+                    note_timbre = 12 - (uint8_t)((uint32_t)(compensated_index - 20) * (compensated_index - 20) * 25 / (2 * (200 - 20) * (200 - 20)));
                     break;
 
                 default:
@@ -233,18 +248,18 @@ float voice_envelope(float frequency) {
             switch (compensated_index) {
                 default:
 #    define OCS_SPEED 10
-#    define OCS_AMP .25
+#    define OCS_AMP 25  // percent
                     // sine wave is slow
                     // note_timbre = (sin((float)compensated_index/10000*OCS_SPEED) * OCS_AMP / 2) + .5;
                     // triangle wave is a bit faster
-                    note_timbre = (uint8_t)abs((compensated_index * OCS_SPEED % 3000) - 1500) * (OCS_AMP / 1500) + (1 - OCS_AMP) / 2;
+                    note_timbre = ((uint32_t)(uint8_t)abs((compensated_index * OCS_SPEED % 3000) - 1500) * OCS_AMP / 1500 + (100 - OCS_AMP) / 2) / 100;
                     break;
             }
             break;
 
         case duty_octave_down:
             glissando   = true;
-            note_timbre = (uint8_t)(100 * (envelope_index % 2) * .125 + .375 * 2);
+            note_timbre = (uint8_t)((100 * (envelope_index % 2) + 6) / 8);
             if ((envelope_index % 4) == 0) note_timbre = 50;
             if ((envelope_index % 8) == 0) note_timbre = 0;
             break;
@@ -258,7 +273,7 @@ float voice_envelope(float frequency) {
                     break;
                 default:
                     // TODO: merge/replace with voice_add_vibrato above
-                    frequency = frequency * vibrato_lut[(int)fmod((((float)compensated_index - (VOICE_VIBRATO_DELAY + 1)) / 1000 * VOICE_VIBRATO_SPEED), VIBRATO_LUT_LENGTH)];
+                    frequency = voice_scale_frequency(frequency, vibrato_lut[((compensated_index - (VOICE_VIBRATO_DELAY + 1)) * VOICE_VIBRATO_SPEED / 1000) % VIBRATO_LUT_LENGTH]);
                     break;
             }
             break;
@@ -325,10 +340,10 @@ float voice_envelope(float frequency) {
 
 // Vibrato functions
 
-void voice_set_vibrato_rate(float rate) { vibrato_rate = rate; }
-void voice_increase_vibrato_rate(float change) { vibrato_rate *= change; }
-void voice_decrease_vibrato_rate(float change) { vibrato_rate /= change; }
-void voice_set_vibrato_strength(float strength) { vibrato_strength = strength; }
+void voice_set_vibrato_rate(float rate) { vibrato_period = rate * 100 * 256; }
+void voice_increase_vibrato_rate(float change) { vibrato_period *= change; }
+void voice_decrease_vibrato_rate(float change) { vibrato_period /= change; }
+void voice_set_vibrato_strength(float strength) { vibrato_strength = strength * 256; }
 void voice_increase_vibrato_strength(float change) { vibrato_strength *= change; }
 void voice_decrease_vibrato_strength(float change) { vibrato_strength /= change; }
 
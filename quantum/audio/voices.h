@@ -23,8 +23,9 @@
 #endif
 #include "wait.h"
 #include "luts.h"
+#include "musical_notes.h"
 
-float voice_envelope(float frequency);
+audio_freq_t voice_envelope(audio_freq_t frequency);
 
 typedef enum {
     default_voice,
@@ -52,7 +52,8 @@ RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
     v = hsv.v;
 #endif
 
-    region    = h * 6 / 255;
+    // h * 6 / 255 without the division, exact for all 8 bit hues
+    region    = (h * 6 + 1 + (h * 6 >> 8)) >> 8;
     remainder = (h * 2 - region * 85) * 3;
 
     p = (v * (255 - s)) >> 8;
@@ -106,6 +107,20 @@ RGB hsv_to_rgb(HSV hsv) {
 
 RGB hsv_to_rgb_nocie(HSV hsv) { return hsv_to_rgb_impl(hsv, false); }
 
+uint16_t rgb_current_scale(uint32_t channel_sum, uint8_t channel_ma, uint16_t limit_ma) {
+    // Model each channel as drawing channel_ma at 255 and scaling linearly,
+    // so the budget is a maximum sum of channel values.
+    if (channel_ma == 0) {
+        return 256;
+    }
+    uint32_t budget = (uint32_t)limit_ma * 255 / channel_ma;
+
+    if (channel_sum <= budget) {
+        return 256;
+    }
+    return (budget << 8) / channel_sum;
+}
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
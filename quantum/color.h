@@ -91,6 +91,8 @@ typedef struct PACKED {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+// Scale factor (out of 256) that keeps a frame with the given sum of channel values within limit_ma
+uint16_t rgb_current_scale(uint32_t channel_sum, uint8_t channel_ma, uint16_t limit_ma);
 #ifdef RGBW
 void convert_rgb_to_rgbw(LED_TYPE *led);
 #endif
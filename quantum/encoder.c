@@ -23,6 +23,13 @@
 // for memcpy
 #include <string.h>
 
+#ifndef MIN
+#    define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#    define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
 #if !defined(ENCODER_RESOLUTIONS) && !defined(ENCODER_RESOLUTION)
 #    define ENCODER_RESOLUTION 4
 #endif
@@ -41,20 +48,35 @@ static uint8_t encoder_resolutions[] = ENCODER_RESOLUTIONS;
 #ifndef ENCODER_DIRECTION_FLIP
 #    define ENCODER_CLOCKWISE true
 #    define ENCODER_COUNTER_CLOCKWISE false
+// clockwise steps for a change of encoder_value
+#    define ENCODER_CLOCKWISE_STEPS(delta) (-(delta))
 #else
 #    define ENCODER_CLOCKWISE false
 #    define ENCODER_COUNTER_CLOCKWISE true
+#    define ENCODER_CLOCKWISE_STEPS(delta) (delta)
 #endif
 static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
-static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
-static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
+static uint8_t  encoder_state[NUMBER_OF_ENCODERS]  = {0};
+static int8_t   encoder_pulses[NUMBER_OF_ENCODERS] = {0};
+static uint16_t encoder_missed[NUMBER_OF_ENCODERS] = {0};
+
+#ifdef ENCODER_INTERRUPT_DRIVEN
+// pulses decoded in the pin change interrupts since the last encoder_read()
+static volatile int8_t encoder_isr_pulses[NUMBER_OF_ENCODERS] = {0};
+// false for the encoders whose pads can't raise an interrupt, which are polled instead
+static bool encoder_interrupt[NUMBER_OF_ENCODERS] = {0};
+#endif
 
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
 static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
 // row offsets for each hand
 static uint8_t thisHand, thatHand;
+// detents of this half not published to the master yet, and the counts the master confirmed it has
+static int16_t encoder_unsent[NUMBER_OF_ENCODERS] = {0};
+static uint8_t encoder_acked[NUMBER_OF_ENCODERS]  = {0};
+static bool    encoder_acks                       = false;
 #else
 static uint8_t encoder_value[NUMBER_OF_ENCODERS] = {0};
 #endif
@@ -63,6 +85,90 @@ __attribute__((weak)) void encoder_update_user(int8_t index, bool clockwise) {}
 
 __attribute__((weak)) void encoder_update_kb(int8_t index, bool clockwise) { encoder_update_user(index, clockwise); }
 
+__attribute__((weak)) bool encoder_update_delta_user(int8_t index, int8_t steps) { return true; }
+
+__attribute__((weak)) bool encoder_update_delta_kb(int8_t index, int8_t steps) { return encoder_update_delta_user(index, steps); }
+
+// Hands 'steps' clockwise steps to the delta callbacks, or, unless they handled them, one by one to encoder_update_kb
+static void encoder_emit(int8_t index, int8_t steps) {
+    if (!encoder_update_delta_kb(index, steps)) {
+        return;
+    }
+    for (; steps > 0; steps--) {
+        encoder_update_kb(index, true);
+    }
+    for (; steps < 0; steps++) {
+        encoder_update_kb(index, false);
+    }
+}
+
+/* Samples the pads of encoder i and returns the pulse the change since the
+ * last sample makes. A change of both pads at once means a step was missed
+ * in between, those are counted for encoder_missed_steps().
+ */
+static int8_t encoder_decode(uint8_t i) {
+    encoder_state[i] <<= 2;
+    encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+    if ((((encoder_state[i] >> 2) ^ encoder_state[i]) & 0x3) == 0x3) {
+        encoder_missed[i]++;
+    }
+    return encoder_LUT[encoder_state[i] & 0xF];
+}
+
+#ifdef ENCODER_INTERRUPT_DRIVEN
+#    if defined(__AVR__)
+/* The pads have to be on port B, which raises PCINT0 to PCINT7 on the
+ * ATmega32U4 and AT90USB parts; every encoder is sampled per interrupt.
+ */
+static bool encoder_enable_interrupt(uint8_t i) {
+    if ((encoders_pad_a[i] >> PORT_SHIFTER) != PINB_ADDRESS || (encoders_pad_b[i] >> PORT_SHIFTER) != PINB_ADDRESS) {
+        return false;
+    }
+    PCMSK0 |= _BV(encoders_pad_a[i] & 0xF) | _BV(encoders_pad_b[i] & 0xF);
+    PCICR |= _BV(PCIE0);
+    return true;
+}
+
+ISR(PCINT0_vect) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        if (encoder_interrupt[i]) {
+            encoder_isr_pulses[i] += encoder_decode(i);
+        }
+    }
+}
+#    elif defined(PROTOCOL_CHIBIOS)
+#        if !PAL_USE_CALLBACKS
+#            error "ENCODER_INTERRUPT_DRIVEN needs PAL_USE_CALLBACKS set to TRUE in halconf.h"
+#        endif
+static void encoder_pad_callback(void* arg) {
+    uint8_t i = (uintptr_t)arg;
+    encoder_isr_pulses[i] += encoder_decode(i);
+}
+
+/* Every pad needs its own EXTI line, and on STM32 the line is shared by the
+ * pads with the same number on all ports, e.g. A1 and B1. Lines are claimed
+ * by pad number, and an encoder that would share one is left to be polled.
+ */
+static uint32_t encoder_exti_lines;
+
+static bool encoder_enable_interrupt(uint8_t i) {
+    uint32_t lines = (1UL << PAL_PAD(encoders_pad_a[i])) | (1UL << PAL_PAD(encoders_pad_b[i]));
+    if (PAL_PAD(encoders_pad_a[i]) == PAL_PAD(encoders_pad_b[i]) || (encoder_exti_lines & lines)) {
+        return false;
+    }
+    encoder_exti_lines |= lines;
+
+    palSetLineCallback(encoders_pad_a[i], encoder_pad_callback, (void*)(uintptr_t)i);
+    palSetLineCallback(encoders_pad_b[i], encoder_pad_callback, (void*)(uintptr_t)i);
+    palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+    palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+    return true;
+}
+#    else
+static bool encoder_enable_interrupt(uint8_t i) { return false; }
+#    endif
+#endif
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -86,6 +192,9 @@ void encoder_init(void) {
         setPinInputHigh(encoders_pad_b[i]);
 
         encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+#ifdef ENCODER_INTERRUPT_DRIVEN
+        encoder_interrupt[i] = encoder_enable_interrupt(i);
+#endif
     }
 
 #ifdef SPLIT_KEYBOARD
@@ -94,9 +203,9 @@ void encoder_init(void) {
 #endif
 }
 
-static bool encoder_update(int8_t index, uint8_t state) {
-    bool    changed = false;
-    uint8_t i       = index;
+static bool encoder_update(int8_t index, int8_t pulses) {
+    uint8_t i     = index;
+    int8_t  delta = 0;
 
 #ifdef ENCODER_RESOLUTIONS
     int8_t resolution = encoder_resolutions[i];
@@ -107,52 +216,84 @@ static bool encoder_update(int8_t index, uint8_t state) {
 #ifdef SPLIT_KEYBOARD
     index += thisHand;
 #endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
-    if (encoder_pulses[i] >= resolution) {
-        encoder_value[index]++;
-        changed = true;
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+    encoder_pulses[i] += pulses;
+    while (encoder_pulses[i] >= resolution) {
+        delta++;
+        encoder_pulses[i] -= resolution;
     }
-    if (encoder_pulses[i] <= -resolution) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
-        changed = true;
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
+    while (encoder_pulses[i] <= -resolution) {  // direction is arbitrary here, but this clockwise
+        delta--;
+        encoder_pulses[i] += resolution;
     }
-    encoder_pulses[i] %= resolution;
-    return changed;
+    if (delta == 0) {
+        return false;
+    }
+
+    encoder_value[index] += delta;
+#ifdef SPLIT_KEYBOARD
+    encoder_unsent[i] = MAX(MIN(encoder_unsent[i] + delta, INT16_MAX), INT16_MIN);
+#endif
+    encoder_emit(index, ENCODER_CLOCKWISE_STEPS(delta));
+    return true;
 }
 
 bool encoder_read(void) {
     bool changed = false;
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        encoder_state[i] <<= 2;
-        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        changed |= encoder_update(i, encoder_state[i]);
+#ifdef ENCODER_INTERRUPT_DRIVEN
+        if (encoder_interrupt[i]) {
+            int8_t pulses;
+            ATOMIC_BLOCK_FORCEON {
+                pulses                = encoder_isr_pulses[i];
+                encoder_isr_pulses[i] = 0;
+            }
+            changed |= encoder_update(i, pulses);
+            continue;
+        }
+#endif
+        changed |= encoder_update(i, encoder_decode(i));
     }
     return changed;
 }
 
+uint16_t encoder_missed_steps(uint8_t index) {
+    uint16_t missed;
+    ATOMIC_BLOCK_FORCEON { missed = encoder_missed[index]; }
+    return missed;
+}
+
 #ifdef SPLIT_KEYBOARD
 void last_encoder_activity_trigger(void);
 
-void encoder_state_raw(uint8_t* slave_state) { memcpy(slave_state, &encoder_value[thisHand], sizeof(uint8_t) * NUMBER_OF_ENCODERS); }
+/* Publishes this half's detents for the master. The published counts stay
+ * within 127 detents of what the master confirmed, so its int8_t difference
+ * can't wrap; any more detents wait for the next confirmation.
+ */
+void encoder_state_raw(uint8_t* slave_state) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        int8_t  unacked = encoder_acks ? (int8_t)(slave_state[i] - encoder_acked[i]) : 0;
+        int16_t sent    = MAX(MIN(encoder_unsent[i], INT8_MAX - unacked), -INT8_MAX - unacked);
+        slave_state[i] += sent;
+        encoder_unsent[i] -= sent;
+    }
+}
+
+void encoder_update_ack_raw(uint8_t* ack_state) {
+    memcpy(encoder_acked, ack_state, sizeof(uint8_t) * NUMBER_OF_ENCODERS);
+    encoder_acks = true;
+}
+
+void encoder_state_ack_raw(uint8_t* ack_state) { memcpy(ack_state, &encoder_value[thatHand], sizeof(uint8_t) * NUMBER_OF_ENCODERS); }
 
 void encoder_update_raw(uint8_t* slave_state) {
     bool changed = false;
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
         uint8_t index = i + thatHand;
-        int8_t  delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            changed = true;
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
+        int8_t  delta = MAX((int8_t)(slave_state[i] - encoder_value[index]), -INT8_MAX);
+        if (delta != 0) {
+            encoder_value[index] += delta;
             changed = true;
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
+            encoder_emit(index, ENCODER_CLOCKWISE_STEPS(delta));
         }
     }
 
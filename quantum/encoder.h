@@ -22,10 +22,19 @@
 void encoder_init(void);
 bool encoder_read(void);
 
+// steps lost because both pads changed between two samples
+uint16_t encoder_missed_steps(uint8_t index);
+
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
+// all detents an encoder turned since the last scan at once, positive clockwise; return true to also get them one by one through encoder_update_kb()
+bool encoder_update_delta_kb(int8_t index, int8_t steps);
+bool encoder_update_delta_user(int8_t index, int8_t steps);
 
 #ifdef SPLIT_KEYBOARD
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
+// the counts the master has applied, sent back so the slave never gets more than 127 detents ahead of them
+void encoder_state_ack_raw(uint8_t* ack_state);
+void encoder_update_ack_raw(uint8_t* ack_state);
 #endif
@@ -21,12 +21,14 @@
 #include <stdbool.h>
 #include "quantum.h"
 #include "led_matrix.h"
+#include "backlight.h"
 #include "progmem.h"
-#include "config.h"
 #include "eeprom.h"
 #include <string.h>
 #include <math.h>
 
+#include <lib/lib8tion/lib8tion.h>
+
 led_eeconfig_t led_matrix_eeconfig;
 
 #ifndef MAX
@@ -37,32 +39,74 @@ led_eeconfig_t led_matrix_eeconfig;
 #    define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
-#ifndef LED_DISABLE_AFTER_TIMEOUT
-#    define LED_DISABLE_AFTER_TIMEOUT 0
+#if !defined(LED_MATRIX_MAXIMUM_BRIGHTNESS) || LED_MATRIX_MAXIMUM_BRIGHTNESS > 255
+#    define LED_MATRIX_MAXIMUM_BRIGHTNESS 255
 #endif
 
-#ifndef LED_DISABLE_WHEN_USB_SUSPENDED
-#    define LED_DISABLE_WHEN_USB_SUSPENDED false
+// Generic effect runners
+#ifdef __AVR__
+#    define LED_MATRIX_RUNNER
+#else
+#    define LED_MATRIX_RUNNER static inline __attribute__((always_inline))
 #endif
+#include "led_matrix_runners/effect_runner_reactive.h"
 
-#ifndef EECONFIG_LED_MATRIX
-#    define EECONFIG_LED_MATRIX EECONFIG_RGBLIGHT
-#endif
+// ------------------------------------------
+// -----Begin led effect includes macros-----
+#define LED_MATRIX_EFFECT(name)
+#define LED_MATRIX_CUSTOM_EFFECT_IMPLS
 
-#if !defined(LED_MATRIX_MAXIMUM_BRIGHTNESS) || LED_MATRIX_MAXIMUM_BRIGHTNESS > 255
-#    define LED_MATRIX_MAXIMUM_BRIGHTNESS 255
+#include "led_matrix_animations/led_matrix_effects.inc"
+
+#undef LED_MATRIX_CUSTOM_EFFECT_IMPLS
+#undef LED_MATRIX_EFFECT
+// -----End led effect includes macros-------
+// ------------------------------------------
+
+// LED_DISABLE_AFTER_TIMEOUT is in minutes
+#if defined(LED_DISABLE_AFTER_TIMEOUT) && !defined(LED_DISABLE_TIMEOUT)
+#    define LED_DISABLE_TIMEOUT (LED_DISABLE_AFTER_TIMEOUT * 60000UL)
 #endif
 
-bool g_suspend_state = false;
+#ifndef LED_DISABLE_TIMEOUT
+#    define LED_DISABLE_TIMEOUT 0
+#endif
 
-// Global tick at 20 Hz
-uint32_t g_tick = 0;
+#ifndef LED_DISABLE_WHEN_USB_SUSPENDED
+#    define LED_DISABLE_WHEN_USB_SUSPENDED false
+#endif
 
-// Ticks since this key was last hit.
-uint8_t g_key_hit[DRIVER_LED_TOTAL];
+#ifndef EECONFIG_LED_MATRIX
+#    define EECONFIG_LED_MATRIX EECONFIG_RGBLIGHT
+#endif
 
-// Ticks since any key was last hit.
-uint32_t g_any_key_hit = 0;
+// globals
+bool     g_suspend_state = false;
+uint32_t g_led_timer;
+uint8_t  g_led_render_buffer[DRIVER_LED_TOTAL];
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+last_hit_t g_last_hit_tracker;
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+
+// internals
+static uint8_t         led_last_enable   = UINT8_MAX;
+static uint8_t         led_last_effect   = UINT8_MAX;
+static effect_params_t led_effect_params = {0, LED_FLAG_ALL};
+static led_task_states led_task_state    = SYNCING;
+#if LED_DISABLE_TIMEOUT > 0
+static uint32_t led_anykey_timer;
+#endif  // LED_DISABLE_TIMEOUT > 0
+
+// What the driver was last given. Effects and indicators may rewrite an LED
+// several times within a frame, only the final values are compared to this.
+static uint8_t led_flushed_buffer[DRIVER_LED_TOTAL];
+static bool    led_render_dirty = true;
+
+// double buffers
+static uint32_t led_timer_buffer;
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+static last_hit_t last_hit_buffer;
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 
 uint32_t eeconfig_read_led_matrix(void) { return eeprom_read_dword(EECONFIG_LED_MATRIX); }
 
@@ -85,11 +129,10 @@ void eeconfig_debug_led_matrix(void) {
     dprintf("led_matrix_eeconfig.speed = %d\n", led_matrix_eeconfig.speed);
 }
 
-uint8_t g_last_led_hit[LED_HITS_TO_REMEMBER] = {255};
-uint8_t g_last_led_count                     = 0;
+__attribute__((weak)) uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i) { return 0; }
 
-uint8_t map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
-    uint8_t led_count = 0;
+uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
+    uint8_t led_count = led_matrix_map_row_column_to_led_kb(row, column, led_i);
     uint8_t led_index = g_led_config.matrix_co[row][column];
     if (led_index != NO_LED) {
         led_i[led_count] = led_index;
@@ -100,88 +143,224 @@ uint8_t map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
 
 void led_matrix_update_pwm_buffers(void) { led_matrix_driver.flush(); }
 
-void led_matrix_set_index_value(int index, uint8_t value) { led_matrix_driver.set_value(index, value); }
+// Effects and indicators both draw into the render buffer, the driver only
+// sees the finished frame.
+void led_matrix_set_index_value(int index, uint8_t value) {
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+    if (g_led_render_buffer[index] == value) return;
 
-void led_matrix_set_index_value_all(uint8_t value) { led_matrix_driver.set_value_all(value); }
+    g_led_render_buffer[index] = value;
+    led_render_dirty           = true;
+}
 
-bool process_led_matrix(uint16_t keycode, keyrecord_t *record) {
-    if (record->event.pressed) {
-        uint8_t led[8];
-        uint8_t led_count = map_row_column_to_led(record->event.key.row, record->event.key.col, led);
-        if (led_count > 0) {
-            for (uint8_t i = LED_HITS_TO_REMEMBER; i > 1; i--) {
-                g_last_led_hit[i - 1] = g_last_led_hit[i - 2];
-            }
-            g_last_led_hit[0] = led[0];
-            g_last_led_count  = MIN(LED_HITS_TO_REMEMBER, g_last_led_count + 1);
-        }
-        for (uint8_t i = 0; i < led_count; i++) g_key_hit[led[i]] = 0;
-        g_any_key_hit = 0;
-    } else {
-#ifdef LED_MATRIX_KEYRELEASES
-        uint8_t led[8];
-        uint8_t led_count = map_row_column_to_led(record->event.key.row, record->event.key.col, led);
-        for (uint8_t i = 0; i < led_count; i++) g_key_hit[led[i]] = 255;
-
-        g_any_key_hit = 255;
-#endif
+void led_matrix_set_index_value_all(uint8_t value) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        led_matrix_set_index_value(i, value);
+    }
+}
+
+// Final stage of the pipeline: only LEDs that differ from the last flushed
+// frame go through the driver. Returns whether any did.
+static bool led_render_pack(void) {
+    bool changed = false;
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        if (g_led_render_buffer[i] == led_flushed_buffer[i]) continue;
+
+        led_flushed_buffer[i] = g_led_render_buffer[i];
+        led_matrix_driver.set_value(i, g_led_render_buffer[i]);
+        changed = true;
     }
-    return true;
+    return changed;
 }
 
-void led_matrix_set_suspend_state(bool state) { g_suspend_state = state; }
+void process_led_matrix(uint8_t row, uint8_t col, bool pressed) {
+#ifndef LED_MATRIX_SPLIT
+    if (!is_keyboard_master()) return;
+#endif
+#if LED_DISABLE_TIMEOUT > 0
+    led_anykey_timer = 0;
+#endif  // LED_DISABLE_TIMEOUT > 0
 
-// All LEDs off
-void led_matrix_all_off(void) { led_matrix_set_index_value_all(0); }
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+    uint8_t led[LED_HITS_TO_REMEMBER];
+    uint8_t led_count = 0;
 
-// Uniform brightness
-void led_matrix_uniform_brightness(void) { led_matrix_set_index_value_all(LED_MATRIX_MAXIMUM_BRIGHTNESS / BACKLIGHT_LEVELS * led_matrix_eeconfig.val); }
+#    if defined(LED_MATRIX_KEYRELEASES)
+    if (!pressed)
+#    elif defined(LED_MATRIX_KEYPRESSES)
+    if (pressed)
+#    endif  // defined(LED_MATRIX_KEYRELEASES)
+    {
+        led_count = led_matrix_map_row_column_to_led(row, col, led);
+    }
 
-void led_matrix_custom(void) {}
+    if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
+        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
+        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
+        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
+        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
+        last_hit_buffer.count--;
+    }
 
-void led_matrix_task(void) {
-    if (!led_matrix_eeconfig.enable) {
-        led_matrix_all_off();
-        led_matrix_indicators();
-        return;
+    for (uint8_t i = 0; i < led_count; i++) {
+        uint8_t index                = last_hit_buffer.count;
+        last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
+        last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
+        last_hit_buffer.index[index] = led[i];
+        last_hit_buffer.tick[index]  = 0;
+        last_hit_buffer.count++;
     }
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+}
 
-    g_tick++;
+void led_matrix_set_suspend_state(bool state) {
+    if (LED_DISABLE_WHEN_USB_SUSPENDED && state) {
+        led_matrix_set_index_value_all(0);  // turn off all LEDs when suspending
+    }
+    g_suspend_state = state;
+}
 
-    if (g_any_key_hit < 0xFFFFFFFF) {
-        g_any_key_hit++;
+static bool led_matrix_none(effect_params_t *params) {
+    if (!params->init) {
+        return false;
     }
 
-    for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
-        if (g_key_hit[led] < 255) {
-            if (g_key_hit[led] == 254) g_last_led_count = MAX(g_last_led_count - 1, 0);
-            g_key_hit[led]++;
+    led_matrix_set_index_value_all(0);
+    return false;
+}
+
+static void led_task_timers(void) {
+#if defined(LED_MATRIX_KEYREACTIVE_ENABLED) || LED_DISABLE_TIMEOUT > 0
+    uint32_t deltaTime = sync_timer_elapsed32(led_timer_buffer);
+#endif  // defined(LED_MATRIX_KEYREACTIVE_ENABLED) || LED_DISABLE_TIMEOUT > 0
+    led_timer_buffer = sync_timer_read32();
+
+    // Update double buffer timers
+#if LED_DISABLE_TIMEOUT > 0
+    if (led_anykey_timer < UINT32_MAX) {
+        if (UINT32_MAX - deltaTime < led_anykey_timer) {
+            led_anykey_timer = UINT32_MAX;
+        } else {
+            led_anykey_timer += deltaTime;
+        }
+    }
+#endif  // LED_DISABLE_TIMEOUT > 0
+
+    // Update double buffer last hit timers
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+    uint8_t count = last_hit_buffer.count;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
+            last_hit_buffer.count--;
+            continue;
         }
+        last_hit_buffer.tick[i] += deltaTime;
     }
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+}
 
-    // Ideally we would also stop sending zeros to the LED driver PWM buffers
-    // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool    suspend_backlight = ((g_suspend_state && LED_DISABLE_WHEN_USB_SUSPENDED) || (LED_DISABLE_AFTER_TIMEOUT > 0 && g_any_key_hit > LED_DISABLE_AFTER_TIMEOUT * 60 * 20));
-    uint8_t effect            = suspend_backlight ? 0 : led_matrix_eeconfig.mode;
+static void led_task_sync(void) {
+    // next task
+    if (sync_timer_elapsed32(g_led_timer) >= LED_MATRIX_LED_FLUSH_LIMIT) led_task_state = STARTING;
+}
+
+static void led_task_start(void) {
+    // reset iter
+    led_effect_params.iter = 0;
+
+    // update double buffers
+    g_led_timer = led_timer_buffer;
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+    g_last_hit_tracker = last_hit_buffer;
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+
+    // next task
+    led_task_state = RENDERING;
+}
+
+static void led_task_render(uint8_t effect) {
+    bool rendering         = false;
+    led_effect_params.init = (effect != led_last_effect) || (led_matrix_eeconfig.enable != led_last_enable);
 
-    // this gets ticked at 20 Hz.
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
-        case LED_MATRIX_UNIFORM_BRIGHTNESS:
-            led_matrix_uniform_brightness();
-            break;
-        default:
-            led_matrix_custom();
+        case LED_MATRIX_NONE:
+            rendering = led_matrix_none(&led_effect_params);
             break;
+
+// ---------------------------------------------
+// -----Begin led effect switch case macros-----
+#define LED_MATRIX_EFFECT(name, ...)          \
+    case LED_MATRIX_##name:                   \
+        rendering = name(&led_effect_params); \
+        break;
+#include "led_matrix_animations/led_matrix_effects.inc"
+#undef LED_MATRIX_EFFECT
+            // -----End led effect switch case macros-------
+            // ---------------------------------------------
     }
 
-    if (!suspend_backlight) {
-        led_matrix_indicators();
+    led_effect_params.iter++;
+
+    // next task
+    if (!rendering) {
+        led_task_state = FLUSHING;
     }
+}
+
+static void led_task_flush(uint8_t effect) {
+    // update last trackers after the first full render so we can init over several frames
+    led_last_effect = effect;
+    led_last_enable = led_matrix_eeconfig.enable;
 
-    // Tell the LED driver to update its state
-    led_matrix_driver.flush();
+    // a frame that ends up as it was never reaches the driver
+    if (led_render_dirty) {
+        if (led_render_pack()) {
+            led_matrix_update_pwm_buffers();
+        }
+        led_render_dirty = false;
+    }
+
+    // next task
+    led_task_state = SYNCING;
+}
+
+void led_matrix_task(void) {
+    led_task_timers();
+
+    // Ideally we would also stop sending zeros to the LED driver PWM buffers
+    // while suspended and just do a software shutdown. This is a cheap hack for now.
+    bool suspend_backlight =
+#if LED_DISABLE_WHEN_USB_SUSPENDED == true
+        g_suspend_state ||
+#endif  // LED_DISABLE_WHEN_USB_SUSPENDED == true
+#if LED_DISABLE_TIMEOUT > 0
+        (led_anykey_timer > (uint32_t)LED_DISABLE_TIMEOUT) ||
+#endif  // LED_DISABLE_TIMEOUT > 0
+        false;
+
+    uint8_t effect = suspend_backlight || !led_matrix_eeconfig.enable ? 0 : led_matrix_eeconfig.mode;
+
+    switch (led_task_state) {
+        case STARTING:
+            led_task_start();
+            break;
+        case RENDERING:
+            led_task_render(effect);
+            // indicators draw over the finished frame once, and also
+            // while the matrix is disabled
+            if (led_task_state == FLUSHING && !suspend_backlight) {
+                led_matrix_indicators();
+            }
+            break;
+        case FLUSHING:
+            led_task_flush(effect);
+            break;
+        case SYNCING:
+            led_task_sync();
+            break;
+    }
 }
 
 void led_matrix_indicators(void) {
@@ -193,33 +372,23 @@ __attribute__((weak)) void led_matrix_indicators_kb(void) {}
 
 __attribute__((weak)) void led_matrix_indicators_user(void) {}
 
-// void led_matrix_set_indicator_index(uint8_t *index, uint8_t row, uint8_t column)
-// {
-//  if (row >= MATRIX_ROWS)
-//  {
-//      // Special value, 255=none, 254=all
-//      *index = row;
-//  }
-//  else
-//  {
-//      // This needs updated to something like
-//      // uint8_t led[8];
-//      // uint8_t led_count = map_row_column_to_led(row, column, led);
-//      // for(uint8_t i = 0; i < led_count; i++)
-//      map_row_column_to_led(row, column, index);
-//  }
-// }
-
 void led_matrix_init(void) {
     led_matrix_driver.init();
 
     // Wait half a second for the driver to finish initializing
     wait_ms(500);
 
-    // clear the key hits
-    for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
-        g_key_hit[led] = 255;
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+    g_last_hit_tracker.count = 0;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
+        g_last_hit_tracker.tick[i] = UINT16_MAX;
+    }
+
+    last_hit_buffer.count = 0;
+    for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
+        last_hit_buffer.tick[i] = UINT16_MAX;
     }
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 
     if (!eeconfig_is_enabled()) {
         dprintf("led_matrix_init_drivers eeconfig is not enabled.\n");
@@ -272,8 +441,6 @@ static uint8_t decrement(uint8_t value, uint8_t step, uint8_t min, uint8_t max)
 //     }
 // }
 
-uint32_t led_matrix_get_tick(void) { return g_tick; }
-
 void led_matrix_toggle(void) {
     led_matrix_eeconfig.enable ^= 1;
     eeconfig_update_led_matrix(led_matrix_eeconfig.raw);
@@ -19,23 +19,60 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "led_matrix_types.h"
 
 #ifndef BACKLIGHT_ENABLE
 #    error You must define BACKLIGHT_ENABLE with LED_MATRIX_ENABLE
 #endif
 
+#ifndef LED_MATRIX_LED_FLUSH_LIMIT
+#    define LED_MATRIX_LED_FLUSH_LIMIT 16
+#endif
+
+#ifndef LED_MATRIX_LED_PROCESS_LIMIT
+#    define LED_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
+#endif
+
+#if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    define LED_MATRIX_USE_LIMITS(min, max)                        \
+        uint8_t min = LED_MATRIX_LED_PROCESS_LIMIT * params->iter; \
+        uint8_t max = min + LED_MATRIX_LED_PROCESS_LIMIT;          \
+        if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+#else
+#    define LED_MATRIX_USE_LIMITS(min, max) \
+        uint8_t min = 0;                    \
+        uint8_t max = DRIVER_LED_TOTAL;
+#endif
+
+#define LED_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
 enum led_matrix_effects {
-    LED_MATRIX_UNIFORM_BRIGHTNESS = 1,
-    // All new effects go above this line
+    LED_MATRIX_NONE = 0,
+
+// --------------------------------------
+// -----Begin led effect enum macros-----
+#define LED_MATRIX_EFFECT(name, ...) LED_MATRIX_##name,
+#include "led_matrix_animations/led_matrix_effects.inc"
+#undef LED_MATRIX_EFFECT
+    // --------------------------------------
+    // -----End led effect enum macros-------
+
     LED_MATRIX_EFFECT_MAX
 };
 
+uint8_t led_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
+uint8_t led_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i);
+
 void led_matrix_set_index_value(int index, uint8_t value);
 void led_matrix_set_index_value_all(uint8_t value);
 
+void process_led_matrix(uint8_t row, uint8_t col, bool pressed);
+
 // This runs after another backlight effect and replaces
-// colors already set
+// values already set
 void led_matrix_indicators(void);
 void led_matrix_indicators_kb(void);
 void led_matrix_indicators_user(void);
@@ -54,10 +91,6 @@ void led_matrix_task(void);
 // If the buffer is dirty, it will update the driver with the buffer.
 void led_matrix_update_pwm_buffers(void);
 
-bool process_led_matrix(uint16_t keycode, keyrecord_t *record);
-
-uint32_t led_matrix_get_tick(void);
-
 void    led_matrix_toggle(void);
 void    led_matrix_enable(void);
 void    led_matrix_enable_noeeprom(void);
@@ -91,4 +124,10 @@ extern const led_matrix_driver_t led_matrix_driver;
 
 extern led_eeconfig_t led_matrix_eeconfig;
 
+extern bool         g_suspend_state;
+extern uint32_t     g_led_timer;
 extern led_config_t g_led_config;
+extern uint8_t      g_led_render_buffer[DRIVER_LED_TOTAL];
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+extern last_hit_t g_last_hit_tracker;
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+
+typedef uint8_t (*reactive_f)(uint8_t val, uint8_t offset);
+
+LED_MATRIX_RUNNER bool effect_runner_reactive(effect_params_t* params, reactive_f effect_func) {
+    LED_MATRIX_USE_LIMITS(led_min, led_max);
+
+    // a hit fades out within a second at the lowest speed, twice as fast with each step
+    uint8_t  speed    = led_matrix_eeconfig.speed;
+    uint16_t max_tick = 1023 >> speed;
+    for (uint8_t i = led_min; i < led_max; i++) {
+        LED_MATRIX_TEST_LED_FLAGS();
+        uint16_t tick = max_tick;
+        // Reverse search to find most recent key hit
+        for (int8_t j = g_last_hit_tracker.count - 1; j >= 0; j--) {
+            if (g_last_hit_tracker.index[j] == i && g_last_hit_tracker.tick[j] < tick) {
+                tick = g_last_hit_tracker.tick[j];
+                break;
+            }
+        }
+
+        uint8_t offset = (tick << speed) >> 2;
+        led_matrix_set_index_value(i, effect_func(led_matrix_eeconfig.val, offset));
+    }
+    return led_max < DRIVER_LED_TOTAL;
+}
+
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
@@ -16,6 +16,7 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
 #include "keycode.h"
 #include "host.h"
 #include "timer.h"
@@ -40,7 +41,259 @@ static uint8_t        mousekey_wheel_repeat = 0;
 static uint16_t mouse_timer = 0;
 #endif
 
-#ifndef MK_3_SPEED
+#if defined(MK_SUBPIXEL)
+
+/*
+ * Sub-pixel mouse keys
+ *
+ *  Speeds are kept in pixels (or wheel steps) per second with 8 fractional
+ *  bits. Each report moves by speed * milliseconds since the previous one and
+ *  the fraction short of a whole pixel is carried over to the next, so the
+ *  motion per second depends neither on how often mousekey_task() runs nor on
+ *  rounding, also on diagonals.
+ */
+#    define MK_FRACTION_BITS 8
+#    define MK_SPEED(units_per_second) ((int32_t)(units_per_second) << MK_FRACTION_BITS)
+/* speed * ms making one pixel */
+#    define MK_PIXEL MK_SPEED(1000)
+
+enum { mk_cursor, mk_wheel, mk_group_COUNT };
+enum { mk_axis_x, mk_axis_y, mk_axis_v, mk_axis_h, mk_axis_COUNT };
+
+typedef struct {
+    uint16_t initial;
+    uint16_t base;
+    uint16_t decelerated;
+    uint16_t accelerated;
+    uint16_t acceleration_time;
+} mousekey_curve_t;
+
+static const mousekey_curve_t mk_curves[mk_group_COUNT] = {
+    {MOUSEKEY_INITIAL_SPEED, MOUSEKEY_BASE_SPEED, MOUSEKEY_DECELERATED_SPEED, MOUSEKEY_ACCELERATED_SPEED, MOUSEKEY_ACCELERATION_TIME},
+    {MOUSEKEY_WHEEL_INITIAL_MOVEMENTS, MOUSEKEY_WHEEL_BASE_MOVEMENTS, MOUSEKEY_WHEEL_DECELERATED_MOVEMENTS, MOUSEKEY_WHEEL_ACCELERATED_MOVEMENTS, MOUSEKEY_WHEEL_ACCELERATION_TIME},
+};
+
+/* milliseconds between the initial key press and the start of the motion (0-2550) */
+uint8_t mk_delay = MOUSEKEY_DELAY / 10;
+/* milliseconds between reports (0-255) */
+uint8_t mk_interval    = MOUSEKEY_INTERVAL;
+uint8_t mk_wheel_delay = MOUSEKEY_WHEEL_DELAY / 10;
+
+static int8_t  mousekey_dir[mk_axis_COUNT]       = {0};
+static int32_t mousekey_remainder[mk_axis_COUNT] = {0};
+#    if MK_CURVE == MK_CURVE_INERTIA
+static int32_t mousekey_velocity[mk_axis_COUNT] = {0};
+#    endif
+/* when the motion of each group started, and when it was last applied */
+static uint16_t mousekey_start[mk_group_COUNT] = {0};
+static uint16_t last_timer_c                   = 0;
+static uint16_t last_timer_w                   = 0;
+
+static bool mousekey_held(uint8_t group) { return mousekey_dir[group * 2] || mousekey_dir[group * 2 + 1]; }
+
+static bool mousekey_moving(uint8_t group) {
+#    if MK_CURVE == MK_CURVE_INERTIA
+    return mousekey_held(group) || mousekey_velocity[group * 2] || mousekey_velocity[group * 2 + 1];
+#    else
+    return mousekey_held(group);
+#    endif
+}
+
+static uint16_t mousekey_delay(uint8_t group) { return (group == mk_cursor ? mk_delay : mk_wheel_delay) * 10; }
+
+/* Speed of the group 'held' ms after its motion started */
+static int32_t mousekey_speed(uint8_t group, uint16_t held) {
+    const mousekey_curve_t *curve = &mk_curves[group];
+
+    if (mousekey_accel & (1 << 2)) return MK_SPEED(curve->accelerated);
+    if (mousekey_accel & (1 << 1)) return MK_SPEED(curve->base);
+    if (mousekey_accel & (1 << 0)) return MK_SPEED(curve->decelerated);
+#    if MK_CURVE == MK_CURVE_INERTIA
+    // the velocity eases towards it by itself
+    return MK_SPEED(curve->base);
+#    else
+    if (held >= curve->acceleration_time) return MK_SPEED(curve->base);
+
+    // a speed times a long acceleration time does not fit into 32 bits
+    int64_t ramp = (int64_t)MK_SPEED(curve->base - curve->initial) * held / curve->acceleration_time;
+#        if MK_CURVE == MK_CURVE_QUADRATIC
+    ramp = ramp * held / curve->acceleration_time;
+#        endif
+    return MK_SPEED(curve->initial) + (int32_t)ramp;
+#    endif
+}
+
+#    if MK_CURVE == MK_CURVE_INERTIA
+/* Moves the axis' velocity 'dt' ms closer to its target, as a first order lag,
+ * and returns the distance covered meanwhile.
+ */
+static int32_t mousekey_inertia(uint8_t axis, int32_t speed, int32_t initial, uint8_t dt) {
+    int32_t const target   = mousekey_dir[axis] * speed;
+    int32_t       velocity = mousekey_velocity[axis];
+
+    // start off at the initial speed, but keep moving the other way until friction turned it around
+    if (mousekey_dir[axis] && mousekey_dir[axis] * velocity >= 0 && labs(velocity) < initial) {
+        velocity = mousekey_dir[axis] * initial;
+    }
+    uint16_t const time  = (target ^ velocity) >= 0 && labs(target) > labs(velocity) ? mk_curves[axis / 2].acceleration_time : MOUSEKEY_FRICTION_TIME;
+    int32_t        eased = dt >= time ? target : velocity + (int32_t)((int64_t)(target - velocity) * dt / time);
+    // stopped, below one unit per second
+    if (!target && labs(eased) < MK_SPEED(1)) eased = 0;
+    mousekey_velocity[axis] = eased;
+
+    // the integral of the lag, so a coasting motion goes equally far whatever the step
+    return (int32_t)((int64_t)target * dt + (int64_t)time * (velocity - eased));
+}
+#    endif
+
+/* Takes the whole pixels off the axis' remainder */
+static int8_t mousekey_whole(uint8_t axis, int8_t max) {
+    int32_t units = mousekey_remainder[axis] / MK_PIXEL;
+    if (units > max || units < -max) {
+        // drop what doesn't fit into a report rather than lag behind
+        units = units > 0 ? max : -max;
+        mousekey_remainder[axis] %= MK_PIXEL;
+    } else {
+        mousekey_remainder[axis] -= units * MK_PIXEL;
+    }
+    return units;
+}
+
+/* Advances both axes of the group to now, every mk_interval ms at most */
+static void mousekey_move(uint8_t group, uint16_t *last, int8_t max, int8_t *moved) {
+    uint8_t const axis = group * 2;
+
+    moved[0] = moved[1] = 0;
+    if (!mousekey_moving(group)) {
+        mousekey_remainder[axis] = mousekey_remainder[axis + 1] = 0;
+        return;
+    }
+
+    uint16_t held = UINT16_MAX;
+    if (mousekey_held(group)) {
+        uint16_t const delay = mousekey_delay(group);
+        held                 = timer_elapsed(mousekey_start[group]);
+        if (held < delay) return;
+        held -= delay;
+    }
+    uint16_t elapsed = timer_elapsed(*last);
+    if (elapsed < mk_interval) return;
+
+    // only the time since the motion started counts, and at most 255 ms of a stalled scan
+    if (elapsed > held) elapsed = held;
+    uint8_t const dt      = elapsed < UINT8_MAX ? elapsed : UINT8_MAX;
+    int32_t       speed   = mousekey_speed(group, held);
+    int32_t       initial = MK_SPEED(mk_curves[group].initial);
+
+    // diagonal move [1/sqrt(2)], before the truncation to whole pixels
+    if (mousekey_dir[axis] && mousekey_dir[axis + 1]) {
+        speed   = speed * 181 >> 8;
+        initial = initial * 181 >> 8;
+    }
+
+    for (uint8_t i = 0; i < 2; i++) {
+#    if MK_CURVE == MK_CURVE_INERTIA
+        mousekey_remainder[axis + i] += mousekey_inertia(axis + i, speed, initial, dt);
+#    else
+        mousekey_remainder[axis + i] += mousekey_dir[axis + i] * speed * dt;
+#    endif
+        moved[i] = mousekey_whole(axis + i, max);
+    }
+    *last = timer_read();
+}
+
+void mousekey_task(void) {
+    int8_t cursor[2], wheel[2];
+
+    mousekey_move(mk_cursor, &last_timer_c, MOUSEKEY_MOVE_MAX, cursor);
+    mousekey_move(mk_wheel, &last_timer_w, MOUSEKEY_WHEEL_MAX, wheel);
+    // replaces the initial steps set by mousekey_on(), which have been sent already
+    mouse_report.x = cursor[0];
+    mouse_report.y = cursor[1];
+    mouse_report.v = wheel[0];
+    mouse_report.h = wheel[1];
+
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+}
+
+static void mousekey_press(uint8_t axis, int8_t dir) {
+    uint8_t const group = axis / 2;
+
+    if (!mousekey_held(group)) {
+        // a coasting motion goes on without another delay
+        mousekey_start[group] = mousekey_moving(group) ? timer_read() - mousekey_delay(group) : timer_read();
+    }
+    mousekey_dir[axis] = dir;
+}
+
+void mousekey_on(uint8_t code) {
+    // a first step right away, mousekey_task() takes over after the delay
+    if (code == KC_MS_UP) {
+        mousekey_press(mk_axis_y, -1);
+        mouse_report.y = -MOUSEKEY_MOVE_DELTA;
+    } else if (code == KC_MS_DOWN) {
+        mousekey_press(mk_axis_y, 1);
+        mouse_report.y = MOUSEKEY_MOVE_DELTA;
+    } else if (code == KC_MS_LEFT) {
+        mousekey_press(mk_axis_x, -1);
+        mouse_report.x = -MOUSEKEY_MOVE_DELTA;
+    } else if (code == KC_MS_RIGHT) {
+        mousekey_press(mk_axis_x, 1);
+        mouse_report.x = MOUSEKEY_MOVE_DELTA;
+    } else if (code == KC_MS_WH_UP) {
+        mousekey_press(mk_axis_v, 1);
+        mouse_report.v = MOUSEKEY_WHEEL_DELTA;
+    } else if (code == KC_MS_WH_DOWN) {
+        mousekey_press(mk_axis_v, -1);
+        mouse_report.v = -MOUSEKEY_WHEEL_DELTA;
+    } else if (code == KC_MS_WH_LEFT) {
+        mousekey_press(mk_axis_h, -1);
+        mouse_report.h = -MOUSEKEY_WHEEL_DELTA;
+    } else if (code == KC_MS_WH_RIGHT) {
+        mousekey_press(mk_axis_h, 1);
+        mouse_report.h = MOUSEKEY_WHEEL_DELTA;
+    } else if (IS_MOUSEKEY_BUTTON(code))
+        mouse_report.buttons |= 1 << (code - KC_MS_BTN1);
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel |= (1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel |= (1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel |= (1 << 2);
+}
+
+void mousekey_off(uint8_t code) {
+    if (code == KC_MS_UP && mousekey_dir[mk_axis_y] < 0)
+        mousekey_dir[mk_axis_y] = 0;
+    else if (code == KC_MS_DOWN && mousekey_dir[mk_axis_y] > 0)
+        mousekey_dir[mk_axis_y] = 0;
+    else if (code == KC_MS_LEFT && mousekey_dir[mk_axis_x] < 0)
+        mousekey_dir[mk_axis_x] = 0;
+    else if (code == KC_MS_RIGHT && mousekey_dir[mk_axis_x] > 0)
+        mousekey_dir[mk_axis_x] = 0;
+    else if (code == KC_MS_WH_UP && mousekey_dir[mk_axis_v] > 0)
+        mousekey_dir[mk_axis_v] = 0;
+    else if (code == KC_MS_WH_DOWN && mousekey_dir[mk_axis_v] < 0)
+        mousekey_dir[mk_axis_v] = 0;
+    else if (code == KC_MS_WH_LEFT && mousekey_dir[mk_axis_h] < 0)
+        mousekey_dir[mk_axis_h] = 0;
+    else if (code == KC_MS_WH_RIGHT && mousekey_dir[mk_axis_h] > 0)
+        mousekey_dir[mk_axis_h] = 0;
+    else if (IS_MOUSEKEY_BUTTON(code))
+        mouse_report.buttons &= ~(1 << (code - KC_MS_BTN1));
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel &= ~(1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel &= ~(1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel &= ~(1 << 2);
+}
+
+#elif !defined(MK_3_SPEED)
 
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
@@ -322,7 +575,7 @@ void mousekey_off(uint8_t code) {
     if (mouse_report.v == 0 && mouse_report.h == 0) mousekey_wheel_repeat = 0;
 }
 
-#else /* #ifndef MK_3_SPEED */
+#else /* #if defined(MK_SUBPIXEL) */
 
 enum { mkspd_unmod, mkspd_0, mkspd_1, mkspd_2, mkspd_COUNT };
 #    ifndef MK_MOMENTARY_ACCEL
@@ -451,7 +704,7 @@ void mousekey_off(uint8_t code) {
 #    endif
 }
 
-#endif /* #ifndef MK_3_SPEED */
+#endif /* #if defined(MK_SUBPIXEL) */
 
 void mousekey_send(void) {
     mousekey_debug();
@@ -466,6 +719,15 @@ void mousekey_clear(void) {
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
+#ifdef MK_SUBPIXEL
+    for (uint8_t i = 0; i < mk_axis_COUNT; i++) {
+        mousekey_dir[i]       = 0;
+        mousekey_remainder[i] = 0;
+#    if MK_CURVE == MK_CURVE_INERTIA
+        mousekey_velocity[i] = 0;
+#    endif
+    }
+#endif
 }
 
 static void mousekey_debug(void) {
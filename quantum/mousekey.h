@@ -20,6 +20,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdint.h>
 #include "host.h"
 
+#if defined(MK_SUBPIXEL) && defined(MK_3_SPEED)
+#    error MK_SUBPIXEL and MK_3_SPEED can not be used together
+#endif
+
 #ifndef MK_3_SPEED
 
 /* max value on report descriptor */
@@ -53,10 +57,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        endif
 #    endif
 #    ifndef MOUSEKEY_INTERVAL
-#        ifndef MK_KINETIC_SPEED
-#            define MOUSEKEY_INTERVAL 50
-#        else
+#        if defined(MK_KINETIC_SPEED)
 #            define MOUSEKEY_INTERVAL 8
+#        elif defined(MK_SUBPIXEL)
+#            define MOUSEKEY_INTERVAL 16
+#        else
+#            define MOUSEKEY_INTERVAL 50
 #        endif
 #    endif
 #    ifndef MOUSEKEY_MAX_SPEED
@@ -103,6 +109,24 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        define MOUSEKEY_WHEEL_DECELERATED_MOVEMENTS 8
 #    endif
 
+#    ifdef MK_SUBPIXEL
+#        define MK_CURVE_LINEAR 0
+#        define MK_CURVE_QUADRATIC 1
+#        define MK_CURVE_INERTIA 2
+#        ifndef MK_CURVE
+#            define MK_CURVE MK_CURVE_LINEAR
+#        endif
+#        ifndef MOUSEKEY_ACCELERATION_TIME
+#            define MOUSEKEY_ACCELERATION_TIME 1000
+#        endif
+#        ifndef MOUSEKEY_WHEEL_ACCELERATION_TIME
+#            define MOUSEKEY_WHEEL_ACCELERATION_TIME 1000
+#        endif
+#        ifndef MOUSEKEY_FRICTION_TIME
+#            define MOUSEKEY_FRICTION_TIME 100
+#        endif
+#    endif
+
 #else /* #ifndef MK_3_SPEED */
 
 #    ifndef MK_C_OFFSET_UNMOD
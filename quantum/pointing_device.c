@@ -24,6 +24,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "pointing_device.h"
 
 static report_mouse_t mouseReport = {};
+// motion not sent yet, more than fits into one report is sent with the next ones
+static int16_t  pending_x = 0, pending_y = 0, pending_v = 0, pending_h = 0;
+static uint16_t last_send = 0;
+
+static int16_t saturating_add(int16_t a, int16_t b) {
+    int32_t sum = (int32_t)a + b;
+    return sum > INT16_MAX ? INT16_MAX : (sum < -INT16_MAX ? -INT16_MAX : sum);
+}
+
+/* Takes as much of 'pending' as fits into a report field of +-max */
+static int16_t take_motion(int16_t *pending, int16_t max) {
+    int16_t motion = *pending > max ? max : (*pending < -max ? -max : *pending);
+    *pending -= motion;
+    return motion;
+}
 
 __attribute__((weak)) bool has_mouse_report_changed(report_mouse_t new, report_mouse_t old) { return (new.buttons != old.buttons) || (new.x&& new.x != old.x) || (new.y&& new.y != old.y) || (new.h&& new.h != old.h) || (new.v&& new.v != old.v); }
 
@@ -31,24 +46,46 @@ __attribute__((weak)) void pointing_device_init(void) {
     // initialize device, if that needs to be done.
 }
 
+void pointing_device_add_motion(int16_t x, int16_t y, int16_t v, int16_t h) {
+    pending_x = saturating_add(pending_x, x);
+    pending_y = saturating_add(pending_y, y);
+    pending_v = saturating_add(pending_v, v);
+    pending_h = saturating_add(pending_h, h);
+}
+
 __attribute__((weak)) void pointing_device_send(void) {
     static report_mouse_t old_report = {};
 
-    // If you need to do other things, like debugging, this is the place to do it.
-    if (has_mouse_report_changed(mouseReport, old_report)) {
-        host_mouse_send(&mouseReport);
-    }
-    // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
+    // motion set in the report adds up with the one from pointing_device_add_motion()
+    pointing_device_add_motion(mouseReport.x, mouseReport.y, mouseReport.v, mouseReport.h);
+    // 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
     mouseReport.x = 0;
     mouseReport.y = 0;
     mouseReport.v = 0;
     mouseReport.h = 0;
-    old_report    = mouseReport;
+
+    // the host only reads a report per polling interval, so until then more motion adds up in the next one
+    if (mouseReport.buttons == old_report.buttons && timer_elapsed(last_send) < POINTING_DEVICE_REPORT_INTERVAL) {
+        return;
+    }
+
+    report_mouse_t report = mouseReport;
+    report.x              = take_motion(&pending_x, MOUSE_REPORT_XY_MAX);
+    report.y              = take_motion(&pending_y, MOUSE_REPORT_XY_MAX);
+    report.v              = take_motion(&pending_v, 127);
+    report.h              = take_motion(&pending_h, 127);
+
+    // If you need to do other things, like debugging, this is the place to do it.
+    if (has_mouse_report_changed(report, old_report)) {
+        host_mouse_send(&report);
+        last_send = timer_read();
+    }
+    old_report = mouseReport;
 }
 
 __attribute__((weak)) void pointing_device_task(void) {
     // gather info and put it in:
-    // mouseReport.x = 127 max -127 min
+    // mouseReport.x = 127 max -127 min, or pointing_device_add_motion() for 16bit sensor deltas
     // mouseReport.y = 127 max -127 min
     // mouseReport.v = 127 max -127 min (scroll vertical)
     // mouseReport.h = 127 max -127 min (scroll horizontal)
@@ -21,9 +21,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "report.h"
 
+/* motion is gathered and sent once per USB poll, button changes are sent right away;
+ * the defaults follow the polling intervals set in vusb.c and usb_descriptor.c
+ */
+#ifndef POINTING_DEVICE_REPORT_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_REPORT_INTERVAL USB_POLLING_INTERVAL_MS
+#    elif defined(PROTOCOL_VUSB)
+#        define POINTING_DEVICE_REPORT_INTERVAL 1
+#    else
+#        define POINTING_DEVICE_REPORT_INTERVAL 10
+#    endif
+#endif
+
 void           pointing_device_init(void);
 void           pointing_device_task(void);
 void           pointing_device_send(void);
+void           pointing_device_add_motion(int16_t x, int16_t y, int16_t v, int16_t h);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t newMouseReport);
-bool           has_mouse_report_changed(report_mouse_t new, report_mouse_t old);
+bool           has_mouse_report_changed(report_mouse_t new_report, report_mouse_t old_report);
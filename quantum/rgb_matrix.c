@@ -18,7 +18,6 @@
 
 #include "rgb_matrix.h"
 #include "progmem.h"
-#include "config.h"
 #include "eeprom.h"
 #include <string.h>
 #include <math.h>
@@ -34,8 +33,17 @@ const point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv); }
 
 // Generic effect runners
+// Where flash allows, each effect gets its own copy of its runner with the
+// per-LED math inlined, instead of calling it through a pointer for every LED.
+#ifdef __AVR__
+#    define RGB_MATRIX_RUNNER
+#else
+#    define RGB_MATRIX_RUNNER static inline __attribute__((always_inline))
+#endif
 #include "rgb_matrix_runners/effect_runner_dx_dy_dist.h"
 #include "rgb_matrix_runners/effect_runner_dx_dy.h"
+#include "rgb_matrix_runners/effect_runner_angle.h"
+#include "rgb_matrix_runners/effect_runner_polar.h"
 #include "rgb_matrix_runners/effect_runner_i.h"
 #include "rgb_matrix_runners/effect_runner_sin_cos_i.h"
 #include "rgb_matrix_runners/effect_runner_reactive.h"
@@ -76,6 +84,26 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 #    define RGB_MATRIX_MAXIMUM_BRIGHTNESS UINT8_MAX
 #endif
 
+#if defined(RGB_MATRIX_CURRENT_LIMIT) && !defined(RGB_MATRIX_CHANNEL_CURRENT)
+#    define RGB_MATRIX_CHANNEL_CURRENT 20
+#endif
+
+#if defined(RGB_MATRIX_RENDER_BUDGET_US) && !defined(RGB_MATRIX_RENDER_SAMPLE_FRAMES)
+#    define RGB_MATRIX_RENDER_SAMPLE_FRAMES 16
+#endif
+
+// Render iterations are timed on the core cycle counter where there is one,
+// otherwise on the millisecond timer
+#if defined(RGB_MATRIX_RENDER_BUDGET_US) && !defined(RGB_MATRIX_RENDER_CLOCK)
+#    if defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE && defined(STM32_SYSCLK)
+#        define RGB_MATRIX_RENDER_CLOCK() chSysGetRealtimeCounterX()
+#        define RGB_MATRIX_RENDER_CLOCK_HZ STM32_SYSCLK
+#    else
+#        define RGB_MATRIX_RENDER_CLOCK() timer_read32()
+#        define RGB_MATRIX_RENDER_CLOCK_HZ 1000
+#    endif
+#endif
+
 #if !defined(RGB_MATRIX_HUE_STEP)
 #    define RGB_MATRIX_HUE_STEP 8
 #endif
@@ -127,6 +155,15 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_RENDER_BUFFER
+RGB g_rgb_render_buffer[DRIVER_LED_TOTAL];
+#endif  // RGB_MATRIX_RENDER_BUFFER
+#ifdef RGB_MATRIX_POLAR_CACHE
+led_polar_t g_led_polar[DRIVER_LED_TOTAL];
+#endif  // RGB_MATRIX_POLAR_CACHE
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+uint8_t g_rgb_led_process_limit = (DRIVER_LED_TOTAL + 4) / 5;
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
 
 // internals
 static uint8_t         rgb_last_enable   = UINT8_MAX;
@@ -136,6 +173,20 @@ static rgb_task_states rgb_task_state    = SYNCING;
 #if RGB_DISABLE_TIMEOUT > 0
 static uint32_t rgb_anykey_timer;
 #endif  // RGB_DISABLE_TIMEOUT > 0
+#ifdef RGB_MATRIX_RENDER_BUFFER
+// What the driver was last given. Effects and indicators may rewrite an LED
+// several times within a frame, only the final values are compared to this.
+static RGB  rgb_flushed_buffer[DRIVER_LED_TOTAL];
+static bool rgb_render_dirty = true;
+#endif  // RGB_MATRIX_RENDER_BUFFER
+#ifdef RGB_MATRIX_CURRENT_LIMIT
+static uint32_t rgb_render_channel_sum = 0;
+#endif  // RGB_MATRIX_CURRENT_LIMIT
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static uint16_t rgb_render_led_cost[RGB_MATRIX_EFFECT_MAX];
+static uint32_t rgb_render_sample_ticks  = 0;
+static uint8_t  rgb_render_sample_frames = 0;
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
 
 // double buffers
 static uint32_t rgb_timer_buffer;
@@ -180,9 +231,54 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
 
 void rgb_matrix_update_pwm_buffers(void) { rgb_matrix_driver.flush(); }
 
+#ifdef RGB_MATRIX_RENDER_BUFFER
+// Effects and indicators both draw into the render buffer, so an indicator
+// overlay is just a second write to RAM. Only a change marks the frame dirty.
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+
+    RGB *led = &g_rgb_render_buffer[index];
+    if (led->r == red && led->g == green && led->b == blue) return;
+
+#ifdef RGB_MATRIX_CURRENT_LIMIT
+    // keep the frame's current estimate up to date as LEDs change
+    rgb_render_channel_sum += (uint16_t)red + green + blue;
+    rgb_render_channel_sum -= (uint16_t)led->r + led->g + led->b;
+#endif
+    led->r           = red;
+    led->g           = green;
+    led->b           = blue;
+    rgb_render_dirty = true;
+}
+
+void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        rgb_matrix_set_color(i, red, green, blue);
+    }
+}
+
+// Final stage of the pipeline: hand the finished frame to the driver in one pass.
+// The current limiter only touches frames that would exceed the budget.
+static void rgb_render_pack(void) {
+#ifdef RGB_MATRIX_CURRENT_LIMIT
+    uint16_t scale = rgb_current_scale(rgb_render_channel_sum, RGB_MATRIX_CHANNEL_CURRENT, RGB_MATRIX_CURRENT_LIMIT);
+    if (scale < 256) {
+        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+            RGB *led = &g_rgb_render_buffer[i];
+            rgb_matrix_driver.set_color(i, (led->r * scale) >> 8, (led->g * scale) >> 8, (led->b * scale) >> 8);
+        }
+        return;
+    }
+#endif
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        rgb_matrix_driver.set_color(i, g_rgb_render_buffer[i].r, g_rgb_render_buffer[i].g, g_rgb_render_buffer[i].b);
+    }
+}
+#else
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color(index, red, green, blue); }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color_all(red, green, blue); }
+#endif  // RGB_MATRIX_RENDER_BUFFER
 
 void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef RGB_MATRIX_SPLIT
@@ -368,13 +464,72 @@ static void rgb_task_render(uint8_t effect) {
     }
 }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static void rgb_task_adapt(uint8_t effect) {
+    // samples taken while switching effects belong to neither of them, so start
+    // from the last cost measured for the new effect and sample it afresh
+    if (effect != rgb_last_effect) {
+        uint16_t cost  = rgb_matrix_get_led_cost(effect);
+        uint32_t limit = cost ? (uint32_t)RGB_MATRIX_RENDER_BUDGET_US * 1000 / cost : (DRIVER_LED_TOTAL + 4) / 5;
+        if (limit < 1) limit = 1;
+        if (limit > DRIVER_LED_TOTAL) limit = DRIVER_LED_TOTAL;
+        g_rgb_led_process_limit  = limit;
+        rgb_render_sample_ticks  = 0;
+        rgb_render_sample_frames = 0;
+        return;
+    }
+
+    if (++rgb_render_sample_frames < RGB_MATRIX_RENDER_SAMPLE_FRAMES) return;
+
+    // A millisecond timer is far coarser than a render iteration, but iterations start
+    // at arbitrary points within a tick, so the sum of their elapsed ticks averages
+    // out to the time actually spent rendering. The limit is worked out from the sums
+    // in one step so that sub-microsecond costs are not rounded away.
+    uint64_t sample_ns = (uint64_t)rgb_render_sample_ticks * 1000000000 / RGB_MATRIX_RENDER_CLOCK_HZ;
+    uint32_t leds      = (uint16_t)rgb_render_sample_frames * DRIVER_LED_TOTAL;
+    uint64_t limit     = sample_ns ? (uint64_t)RGB_MATRIX_RENDER_BUDGET_US * 1000 * leds / sample_ns : DRIVER_LED_TOTAL;
+    if (limit < 1) limit = 1;
+    if (limit > DRIVER_LED_TOTAL) limit = DRIVER_LED_TOTAL;
+    g_rgb_led_process_limit = limit;
+
+    // costs are kept in nanoseconds per LED, saturating for very slow effects
+    uint64_t cost = sample_ns / leds;
+    if (cost > UINT16_MAX) cost = UINT16_MAX;
+    if (effect < RGB_MATRIX_EFFECT_MAX) rgb_render_led_cost[effect] = cost;
+#    ifdef RGB_MATRIX_RENDER_BUDGET_DEBUG
+    dprintf("rgb matrix effect %d costs %uns per led, rendering %d leds per iteration\n", effect, (uint16_t)cost, g_rgb_led_process_limit);
+#    endif  // RGB_MATRIX_RENDER_BUDGET_DEBUG
+
+    rgb_render_sample_ticks  = 0;
+    rgb_render_sample_frames = 0;
+}
+
+uint16_t rgb_matrix_get_led_cost(uint8_t mode) { return mode < RGB_MATRIX_EFFECT_MAX ? rgb_render_led_cost[mode] : 0; }
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
 static void rgb_task_flush(uint8_t effect) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_task_adapt(effect);
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
     // update last trackers after the first full render so we can init over several frames
     rgb_last_effect = effect;
     rgb_last_enable = rgb_matrix_config.enable;
 
+#ifdef RGB_MATRIX_RENDER_BUFFER
+    // a frame that ends up as it was never reaches the driver
+    if (rgb_render_dirty) {
+        if (memcmp(rgb_flushed_buffer, g_rgb_render_buffer, sizeof(rgb_flushed_buffer))) {
+            memcpy(rgb_flushed_buffer, g_rgb_render_buffer, sizeof(rgb_flushed_buffer));
+            rgb_render_pack();
+            rgb_matrix_update_pwm_buffers();
+        }
+        rgb_render_dirty = false;
+    }
+#else
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
+#endif  // RGB_MATRIX_RENDER_BUFFER
 
     // next task
     rgb_task_state = SYNCING;
@@ -400,13 +555,20 @@ void rgb_matrix_task(void) {
         case STARTING:
             rgb_task_start();
             break;
-        case RENDERING:
+        case RENDERING: {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            uint32_t render_start = RGB_MATRIX_RENDER_CLOCK();
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
             rgb_task_render(effect);
             if (effect) {
                 rgb_matrix_indicators();
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
             }
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            rgb_render_sample_ticks += (uint32_t)(RGB_MATRIX_RENDER_CLOCK() - render_start);
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
             break;
+        }
         case FLUSHING:
             rgb_task_flush(effect);
             break;
@@ -431,7 +593,10 @@ void rgb_matrix_indicators_advanced(effect_params_t *params) {
      * and not sure which would be better. Otherwise, this should be called from
      * rgb_task_render, right before the iter++ line.
      */
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#if defined(RGB_MATRIX_RENDER_BUDGET_US)
+    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
+    uint8_t max = DRIVER_LED_TOTAL - min > RGB_MATRIX_LED_PROCESS_LIMIT ? min + RGB_MATRIX_LED_PROCESS_LIMIT : DRIVER_LED_TOTAL;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
     uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
     uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;
     if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
@@ -447,9 +612,25 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+#ifdef RGB_MATRIX_POLAR_CACHE
+// LED positions and k_rgb_matrix_center are fixed, so this only runs once
+static void rgb_matrix_init_polar(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx           = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy           = g_led_config.point[i].y - k_rgb_matrix_center.y;
+        g_led_polar[i].angle = atan2_8(dy, dx);
+        g_led_polar[i].dist  = sqrt16(dx * dx + dy * dy);
+    }
+}
+#endif  // RGB_MATRIX_POLAR_CACHE
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_POLAR_CACHE
+    rgb_matrix_init_polar();
+#endif  // RGB_MATRIX_POLAR_CACHE
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
@@ -41,11 +41,26 @@
 #    define RGB_MATRIX_LED_FLUSH_LIMIT 16
 #endif
 
-#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+// LED angle and distance from the center are cached wherever the RAM can be spared,
+// unless the keyboard opts out with RGB_MATRIX_NO_POLAR_CACHE
+#if !defined(__AVR__) && !defined(RGB_MATRIX_NO_POLAR_CACHE) && !defined(RGB_MATRIX_POLAR_CACHE)
+#    define RGB_MATRIX_POLAR_CACHE
+#endif
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+// The number of LEDs per render iteration adapts to the measured cost of the
+// running effect. It only changes between frames.
+#    undef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT g_rgb_led_process_limit
+#elif !defined(RGB_MATRIX_LED_PROCESS_LIMIT)
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    define RGB_MATRIX_USE_LIMITS(min, max)                        \
+        uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
+        uint8_t max = DRIVER_LED_TOTAL - min > RGB_MATRIX_LED_PROCESS_LIMIT ? min + RGB_MATRIX_LED_PROCESS_LIMIT : DRIVER_LED_TOTAL;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
 #    define RGB_MATRIX_USE_LIMITS(min, max)                        \
         uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
         uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
@@ -157,6 +172,9 @@ void        rgb_matrix_decrease_speed(void);
 void        rgb_matrix_decrease_speed_noeeprom(void);
 led_flags_t rgb_matrix_get_flags(void);
 void        rgb_matrix_set_flags(led_flags_t flags);
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+uint16_t rgb_matrix_get_led_cost(uint8_t mode);
+#endif
 
 #ifndef RGBLIGHT_ENABLE
 #    define eeconfig_update_rgblight_current eeconfig_update_rgb_matrix
@@ -225,3 +243,15 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+#if defined(RGB_MATRIX_CURRENT_LIMIT) && !defined(RGB_MATRIX_RENDER_BUFFER)
+#    define RGB_MATRIX_RENDER_BUFFER
+#endif
+#ifdef RGB_MATRIX_RENDER_BUFFER
+extern RGB g_rgb_render_buffer[DRIVER_LED_TOTAL];
+#endif
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+extern uint8_t g_rgb_led_process_limit;
+#endif
+#ifdef RGB_MATRIX_POLAR_CACHE
+extern led_polar_t g_led_polar[DRIVER_LED_TOTAL];
+#endif
@@ -83,18 +83,36 @@ static void init(void) {
 }
 
 #    ifdef IS31FL3731
+#        ifdef I2C_BUS_ROUTES
+// Chips on different I2C buses are flushed concurrently, one job per bus
+static void flush_bus(uint8_t bus) {
+    if (i2c_address_bus(DRIVER_ADDR_1 << 1) == bus) IS31FL3731_update_pwm_buffers(DRIVER_ADDR_1, 0);
+#            ifdef DRIVER_ADDR_2
+    if (i2c_address_bus(DRIVER_ADDR_2 << 1) == bus) IS31FL3731_update_pwm_buffers(DRIVER_ADDR_2, 1);
+#            endif
+#            ifdef DRIVER_ADDR_3
+    if (i2c_address_bus(DRIVER_ADDR_3 << 1) == bus) IS31FL3731_update_pwm_buffers(DRIVER_ADDR_3, 2);
+#            endif
+#            ifdef DRIVER_ADDR_4
+    if (i2c_address_bus(DRIVER_ADDR_4 << 1) == bus) IS31FL3731_update_pwm_buffers(DRIVER_ADDR_4, 3);
+#            endif
+}
+
+static void flush(void) { i2c_run_per_bus(flush_bus); }
+#        else
 static void flush(void) {
     IS31FL3731_update_pwm_buffers(DRIVER_ADDR_1, 0);
-#        ifdef DRIVER_ADDR_2
+#            ifdef DRIVER_ADDR_2
     IS31FL3731_update_pwm_buffers(DRIVER_ADDR_2, 1);
-#        endif
-#        ifdef DRIVER_ADDR_3
+#            endif
+#            ifdef DRIVER_ADDR_3
     IS31FL3731_update_pwm_buffers(DRIVER_ADDR_3, 2);
-#        endif
-#        ifdef DRIVER_ADDR_4
+#            endif
+#            ifdef DRIVER_ADDR_4
     IS31FL3731_update_pwm_buffers(DRIVER_ADDR_4, 3);
-#        endif
+#            endif
 }
+#        endif
 
 const rgb_matrix_driver_t rgb_matrix_driver = {
     .init          = init,
@@ -103,10 +121,19 @@ const rgb_matrix_driver_t rgb_matrix_driver = {
     .set_color_all = IS31FL3731_set_color_all,
 };
 #    elif defined(IS31FL3733)
+#        ifdef I2C_BUS_ROUTES
+static void flush_bus(uint8_t bus) {
+    if (i2c_address_bus(DRIVER_ADDR_1 << 1) == bus) IS31FL3733_update_pwm_buffers(DRIVER_ADDR_1, 0);
+    if (i2c_address_bus(DRIVER_ADDR_2 << 1) == bus) IS31FL3733_update_pwm_buffers(DRIVER_ADDR_2, 1);
+}
+
+static void flush(void) { i2c_run_per_bus(flush_bus); }
+#        else
 static void flush(void) {
     IS31FL3733_update_pwm_buffers(DRIVER_ADDR_1, 0);
     IS31FL3733_update_pwm_buffers(DRIVER_ADDR_2, 1);
 }
+#        endif
 
 const rgb_matrix_driver_t rgb_matrix_driver = {
     .init = init,
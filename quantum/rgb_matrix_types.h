@@ -64,6 +64,11 @@ typedef struct PACKED {
     uint8_t y;
 } point_t;
 
+typedef struct PACKED {
+    uint8_t angle;
+    uint8_t dist;
+} led_polar_t;
+
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 #define HAS_ANY_FLAGS(bits, flags) ((bits & flags) != 0x00)
 
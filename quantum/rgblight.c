@@ -104,6 +104,10 @@ static uint8_t mode_base_table[] = {
 #    define RGBLIGHT_DEFAULT_SPD 0
 #endif
 
+#if defined(RGBLIGHT_CURRENT_LIMIT) && !defined(RGBLIGHT_CHANNEL_CURRENT)
+#    define RGBLIGHT_CHANNEL_CURRENT 20
+#endif
+
 static inline int is_static_effect(uint8_t mode) { return memchr(static_effect_table, mode, sizeof(static_effect_table)) != NULL; }
 
 #ifdef RGBLIGHT_LED_MAP
@@ -785,9 +789,102 @@ __attribute__((weak)) void rgblight_call_driver(LED_TYPE *start_led, uint8_t num
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
 
+#    ifdef RGBLIGHT_LED_MAP
+// Drivers that can apply the map while sending override this to skip the copy.
+__attribute__((weak)) void ws2812_setleds_mapped(LED_TYPE *ledarray, const uint8_t *map, uint16_t number_of_leds) {
+    LED_TYPE led0[RGBLED_NUM];
+    for (uint8_t i = 0; i < number_of_leds; i++) {
+        led0[i] = ledarray[pgm_read_byte(&map[i])];
+#        ifdef RGBW
+        convert_rgb_to_rgbw(&led0[i]);
+#        endif
+    }
+    rgblight_call_driver(led0, number_of_leds);
+}
+#    endif
+
+// The LED sent i-th, after clipping and the map, if any
+static inline LED_TYPE *rgblight_out_led(uint8_t i) {
+#    ifdef RGBLIGHT_LED_MAP
+    return &led[pgm_read_byte(&led_map[rgblight_ranges.clipping_start_pos + i])];
+#    else
+    return &led[rgblight_ranges.clipping_start_pos + i];
+#    endif
+}
+
+#    if defined(RGBW) || defined(RGBLIGHT_CURRENT_LIMIT)
+// Frames are converted to RGBW and dimmed in here, so that led[] keeps the
+// requested colors for the next frame.
+static LED_TYPE led_out[RGBLED_NUM];
+#    endif
+
+#    ifdef RGBLIGHT_CURRENT_LIMIT
+// Writes the frame scaled to the current budget to led_out, converted to RGBW
+// on the way. The budget is checked against the converted channels, as they
+// are sent. Returns false, and leaves led_out alone, when the frame is within
+// budget.
+static bool rgblight_limit_current(uint8_t num_leds) {
+    uint32_t channel_sum = 0;
+
+    for (uint8_t i = 0; i < num_leds; i++) {
+        LED_TYPE src = *rgblight_out_led(i);
+
+#        ifdef RGBW
+        convert_rgb_to_rgbw(&src);
+        channel_sum += src.w;
+#        endif
+        channel_sum += (uint16_t)src.r + src.g + src.b;
+    }
+
+    uint16_t scale = rgb_current_scale(channel_sum, RGBLIGHT_CHANNEL_CURRENT, RGBLIGHT_CURRENT_LIMIT);
+    if (scale == 256) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < num_leds; i++) {
+        LED_TYPE src = *rgblight_out_led(i);
+
+#        ifdef RGBW
+        convert_rgb_to_rgbw(&src);
+        led_out[i].w = (src.w * scale) >> 8;
+#        endif
+        led_out[i].r = (src.r * scale) >> 8;
+        led_out[i].g = (src.g * scale) >> 8;
+        led_out[i].b = (src.b * scale) >> 8;
+    }
+    return true;
+}
+#    endif
+
+#    ifdef RGBLIGHT_SKIP_UNCHANGED
+// Compares the outgoing frame with a copy of the last one sent, and refreshes
+// the copy. A hash would be smaller but could mistake a real update for a
+// repeat.
+static bool rgblight_frame_changed(uint8_t num_leds) {
+    static LED_TYPE last_sent[RGBLED_NUM];
+    static bool     frame_sent = false;
+    static uint8_t  last_start_pos;
+    static uint8_t  last_num_leds;
+    bool            changed = !frame_sent || last_start_pos != rgblight_ranges.clipping_start_pos || last_num_leds != num_leds;
+
+    for (uint8_t i = 0; i < num_leds; i++) {
+        LED_TYPE *src = rgblight_out_led(i);
+
+        if (memcmp(&last_sent[i], src, sizeof(LED_TYPE)) != 0) {
+            last_sent[i] = *src;
+            changed      = true;
+        }
+    }
+
+    frame_sent     = true;
+    last_start_pos = rgblight_ranges.clipping_start_pos;
+    last_num_leds  = num_leds;
+    return changed;
+}
+#    endif
+
 void rgblight_set(void) {
-    LED_TYPE *start_led;
-    uint8_t   num_leds = rgblight_ranges.clipping_num_leds;
+    uint8_t num_leds = rgblight_ranges.clipping_num_leds;
 
     if (!rgblight_config.enable) {
         for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
@@ -812,22 +909,33 @@ void rgblight_set(void) {
     }
 #    endif
 
-#    ifdef RGBLIGHT_LED_MAP
-    LED_TYPE led0[RGBLED_NUM];
-    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
-        led0[i] = led[pgm_read_byte(&led_map[i])];
+#    ifdef RGBLIGHT_SKIP_UNCHANGED
+    if (!rgblight_frame_changed(num_leds)) {
+        return;
     }
-    start_led = led0 + rgblight_ranges.clipping_start_pos;
-#    else
-    start_led = led + rgblight_ranges.clipping_start_pos;
 #    endif
 
-#    ifdef RGBW
-    for (uint8_t i = 0; i < num_leds; i++) {
-        convert_rgb_to_rgbw(&start_led[i]);
+#    ifdef RGBLIGHT_CURRENT_LIMIT
+    if (rgblight_limit_current(num_leds)) {
+        rgblight_call_driver(led_out, num_leds);
+        return;
     }
 #    endif
+
+#    ifdef RGBLIGHT_LED_MAP
+    // The map is applied by the driver while sending, so led[] is never copied.
+    ws2812_setleds_mapped(led, led_map + rgblight_ranges.clipping_start_pos, num_leds);
+#    else
+    LED_TYPE *start_led = led + rgblight_ranges.clipping_start_pos;
+#        ifdef RGBW
+    for (uint8_t i = 0; i < num_leds; i++) {
+        led_out[i] = start_led[i];
+        convert_rgb_to_rgbw(&led_out[i]);
+    }
+    start_led = led_out;
+#        endif
     rgblight_call_driver(start_led, num_leds);
+#    endif
 }
 #endif
 
@@ -904,10 +1012,16 @@ void rgblight_timer_init(void) {
     RGBLIGHT_SPLIT_SET_CHANGE_TIMER_ENABLE;
 }
 void rgblight_timer_enable(void) {
-    if (!is_static_effect(rgblight_config.mode)) {
-        rgblight_status.timer_enabled = true;
+    // Static modes never run the ticker, so a timer left on by the previous
+    // mode is switched off rather than restarted
+    if (is_static_effect(rgblight_config.mode)) {
+        if (rgblight_status.timer_enabled) {
+            rgblight_timer_disable();
+        }
+        return;
     }
-    animation_status.last_timer = sync_timer_read();
+    rgblight_status.timer_enabled = true;
+    animation_status.last_timer   = sync_timer_read();
     RGBLIGHT_SPLIT_SET_CHANGE_TIMER_ENABLE;
     dprintf("rgblight timer enabled.\n");
 }
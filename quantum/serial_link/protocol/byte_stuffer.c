@@ -97,39 +97,66 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
+static void send_block(uint8_t link, const byte_stuffer_segment_t* segment, uint16_t pos, uint8_t num_non_zero) {
     send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end - start);
+    // A block can span several segments, so send the part contained in each of them
+    uint16_t remaining = num_non_zero - 1;
+    while (remaining > 0) {
+        uint16_t size = segment->size - pos;
+        if (size > remaining) {
+            size = remaining;
+        }
+        if (size > 0) {
+            send_data(link, segment->data + pos, size);
+        }
+        remaining -= size;
+        segment++;
+        pos = 0;
     }
 }
 
-void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
-    const uint8_t zero = 0;
-    if (size > 0) {
-        uint16_t num_non_zero = 1;
-        uint8_t* end          = data + size;
-        uint8_t* start        = data;
-        while (data < end) {
-            if (num_non_zero == 0xFF) {
-                // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start        = data;
-                num_non_zero = 1;
-            } else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start        = data + 1;
-                    num_non_zero = 1;
+void byte_stuffer_send_segments(uint8_t link, const byte_stuffer_segment_t* segments, uint8_t num_segments) {
+    const uint8_t zero       = 0;
+    uint32_t      total_size = 0;
+    uint8_t       i;
+    for (i = 0; i < num_segments; i++) {
+        total_size += segments[i].size;
+    }
+    if (total_size > 0) {
+        uint16_t                      num_non_zero  = 1;
+        const byte_stuffer_segment_t* start_segment = segments;
+        uint16_t                      start_pos     = 0;
+        for (i = 0; i < num_segments; i++) {
+            const byte_stuffer_segment_t* segment = &segments[i];
+            uint16_t                      pos     = 0;
+            while (pos < segment->size) {
+                if (num_non_zero == 0xFF) {
+                    // There's more data after big non-zero block
+                    // So send it, and start a new block
+                    send_block(link, start_segment, start_pos, num_non_zero);
+                    start_segment = segment;
+                    start_pos     = pos;
+                    num_non_zero  = 1;
                 } else {
-                    num_non_zero++;
+                    if (segment->data[pos] == 0) {
+                        // A zero encountered, so send the block
+                        send_block(link, start_segment, start_pos, num_non_zero);
+                        start_segment = segment;
+                        start_pos     = pos + 1;
+                        num_non_zero  = 1;
+                    } else {
+                        num_non_zero++;
+                    }
+                    ++pos;
                 }
-                ++data;
             }
         }
-        send_block(link, start, data, num_non_zero);
+        send_block(link, start_segment, start_pos, num_non_zero);
         send_data(link, &zero, 1);
     }
 }
+
+void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    byte_stuffer_segment_t segment = {.data = data, .size = size};
+    byte_stuffer_send_segments(link, &segment, 1);
+}
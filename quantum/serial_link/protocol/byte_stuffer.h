@@ -29,6 +29,14 @@ SOFTWARE.
 #define MAX_FRAME_SIZE 1024
 #define NUM_LINKS 2
 
+// A part of a frame, several of them can be sent as one frame without
+// first copying them into a single buffer
+typedef struct {
+    const uint8_t* data;
+    uint16_t       size;
+} byte_stuffer_segment_t;
+
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
+void byte_stuffer_send_segments(uint8_t link, const byte_stuffer_segment_t* segments, uint8_t num_segments);
@@ -52,6 +52,10 @@ void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size) {
 
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
     uint32_t crc = crc32_byte(data, size);
-    memcpy(data + size, &crc, 4);
-    byte_stuffer_send_frame(link, data, size + 4);
+    // The crc is sent as a separate segment, so the caller's buffer is never written to
+    byte_stuffer_segment_t segments[] = {
+        {.data = data, .size = size},
+        {.data = (const uint8_t*)&crc, .size = 4},
+    };
+    byte_stuffer_send_segments(link, segments, 2);
 }
@@ -27,34 +27,58 @@ SOFTWARE.
 #include <stdbool.h>
 #include <stddef.h>
 
-#define GET_READ_INDEX() object->state & 3
-#define GET_WRITE_INDEX() (object->state >> 2) & 3
-#define GET_SHARED_INDEX() (object->state >> 4) & 3
-#define GET_DATA_AVAILABLE() (object->state >> 6) & 1
-
-#define SET_READ_INDEX(i) object->state = ((object->state & ~3) | i)
-#define SET_WRITE_INDEX(i) object->state = ((object->state & ~(3 << 2)) | (i << 2))
-#define SET_SHARED_INDEX(i) object->state = ((object->state & ~(3 << 4)) | (i << 4))
-#define SET_DATA_AVAILABLE(i) object->state = ((object->state & ~(1 << 6)) | (i << 6))
-
-void triple_buffer_init(triple_buffer_object_t* object) {
-    object->state = 0;
-    SET_WRITE_INDEX(0);
-    SET_READ_INDEX(1);
-    SET_SHARED_INDEX(2);
-    SET_DATA_AVAILABLE(0);
+// Cores with exclusive load/store instructions (Cortex-M3 and up) swap the indices with a
+// compare and swap of the state, others like Cortex-M0 and AVR use the serial link lock
+#if (defined(__ARM_FEATURE_LDREX) && (__ARM_FEATURE_LDREX & 1)) || (!defined(__arm__) && !defined(__AVR__) && __GCC_ATOMIC_CHAR_LOCK_FREE == 2)
+#    define TRIPLE_BUFFER_LOCK_FREE
+#endif
+
+#define GET_READ_INDEX(state) ((state)&3)
+#define GET_WRITE_INDEX(state) (((state) >> 2) & 3)
+#define GET_SHARED_INDEX(state) (((state) >> 4) & 3)
+#define GET_DATA_AVAILABLE(state) (((state) >> 6) & 1)
+
+#define MAKE_STATE(read, write, shared, available) ((read) | ((write) << 2) | ((shared) << 4) | ((available) << 6))
+
+static inline uint8_t state_after_read(uint8_t state) { return MAKE_STATE(GET_SHARED_INDEX(state), GET_WRITE_INDEX(state), GET_READ_INDEX(state), 0); }
+
+static inline uint8_t state_after_write(uint8_t state) { return MAKE_STATE(GET_READ_INDEX(state), GET_SHARED_INDEX(state), GET_WRITE_INDEX(state), 1); }
+
+void triple_buffer_init(triple_buffer_object_t* object) { object->state = MAKE_STATE(1, 0, 2, 0); }
+
+#ifdef TRIPLE_BUFFER_LOCK_FREE
+
+void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t* object) {
+    uint8_t state = __atomic_load_n(&object->state, __ATOMIC_ACQUIRE);
+    do {
+        if (!GET_DATA_AVAILABLE(state)) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&object->state, &state, state_after_read(state), true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return object->buffer + object_size * GET_SHARED_INDEX(state);
 }
 
+void* triple_buffer_begin_write_internal(uint16_t object_size, triple_buffer_object_t* object) {
+    // Only the writer changes the write index, so there's no need to synchronize
+    uint8_t state = __atomic_load_n(&object->state, __ATOMIC_RELAXED);
+    return object->buffer + object_size * GET_WRITE_INDEX(state);
+}
+
+void triple_buffer_end_write_internal(triple_buffer_object_t* object) {
+    uint8_t state = __atomic_load_n(&object->state, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&object->state, &state, state_after_write(state), true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+    }
+}
+
+#else
+
 void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t* object) {
     serial_link_lock();
-    if (GET_DATA_AVAILABLE()) {
-        uint8_t shared_index = GET_SHARED_INDEX();
-        uint8_t read_index   = GET_READ_INDEX();
-        SET_READ_INDEX(shared_index);
-        SET_SHARED_INDEX(read_index);
-        SET_DATA_AVAILABLE(false);
+    uint8_t state = object->state;
+    if (GET_DATA_AVAILABLE(state)) {
+        object->state = state_after_read(state);
         serial_link_unlock();
-        return object->buffer + object_size * shared_index;
+        return object->buffer + object_size * GET_SHARED_INDEX(state);
     } else {
         serial_link_unlock();
         return NULL;
@@ -62,16 +86,14 @@ void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t*
 }
 
 void* triple_buffer_begin_write_internal(uint16_t object_size, triple_buffer_object_t* object) {
-    uint8_t write_index = GET_WRITE_INDEX();
+    uint8_t write_index = GET_WRITE_INDEX(object->state);
     return object->buffer + object_size * write_index;
 }
 
 void triple_buffer_end_write_internal(triple_buffer_object_t* object) {
     serial_link_lock();
-    uint8_t shared_index = GET_SHARED_INDEX();
-    uint8_t write_index  = GET_WRITE_INDEX();
-    SET_SHARED_INDEX(write_index);
-    SET_WRITE_INDEX(shared_index);
-    SET_DATA_AVAILABLE(true);
+    object->state = state_after_write(object->state);
     serial_link_unlock();
 }
+
+#endif
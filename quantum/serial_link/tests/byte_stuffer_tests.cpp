@@ -47,8 +47,20 @@ class ByteStuffer : public ::testing::Test {
 
     MOCK_METHOD3(validator_recv_frame, void(uint8_t link, uint8_t* data, uint16_t size));
 
-    void                 send_data(uint8_t link, const uint8_t* data, uint16_t size) { std::copy(data, data + size, std::back_inserter(sent_data)); }
+    void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
+        std::copy(data, data + size, std::back_inserter(sent_data));
+        // Bytes not sent straight from the caller's buffer had to be copied somewhere first
+        if (data >= source && data + size <= source + source_size) {
+            bytes_from_source += size;
+        } else {
+            bytes_from_elsewhere += size;
+        }
+    }
     std::vector<uint8_t> sent_data;
+    const uint8_t*       source               = nullptr;
+    uint16_t             source_size          = 0;
+    uint32_t             bytes_from_source    = 0;
+    uint32_t             bytes_from_elsewhere = 0;
 
     static ByteStuffer* Instance;
 };
@@ -387,6 +399,83 @@ TEST_F(ByteStuffer, sends_frame_with_254_non_zeroes_followed_by_zero) {
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
+TEST_F(ByteStuffer, sends_segments_as_one_frame) {
+    uint8_t                first[]    = {9, 0};
+    uint8_t                second[]   = {0x68, 0, 0x55};
+    byte_stuffer_segment_t segments[] = {{first, 2}, {second, 3}};
+    byte_stuffer_send_segments(0, segments, 2);
+    uint8_t expected[] = {2, 9, 2, 0x68, 2, 0x55, 0};
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+}
+
+TEST_F(ByteStuffer, sends_segments_with_empty_segments) {
+    uint8_t                data[]     = {5, 0x77};
+    byte_stuffer_segment_t segments[] = {{NULL, 0}, {data, 1}, {NULL, 0}, {data + 1, 1}, {NULL, 0}};
+    byte_stuffer_send_segments(1, segments, 5);
+    uint8_t expected[] = {3, 5, 0x77, 0};
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+}
+
+TEST_F(ByteStuffer, does_nothing_when_sending_only_empty_segments) {
+    byte_stuffer_segment_t segments[] = {{NULL, 0}, {NULL, 0}};
+    byte_stuffer_send_segments(0, segments, 2);
+    EXPECT_EQ(sent_data.size(), 0);
+}
+
+TEST_F(ByteStuffer, sends_segments_with_255_non_zeroes_split_in_the_middle) {
+    uint8_t data[255];
+    int     i;
+    for (i = 0; i < 255; i++) {
+        data[i] = i + 1;
+    }
+    byte_stuffer_segment_t segments[] = {{data, 100}, {data + 100, 155}};
+    byte_stuffer_send_segments(0, segments, 2);
+    uint8_t expected[258];
+    expected[0] = 0xFF;
+    for (i = 1; i < 255; i++) {
+        expected[i] = i;
+    }
+    expected[255] = 2;
+    expected[256] = 255;
+    expected[257] = 0;
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+}
+
+TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_of_segments) {
+    uint8_t original_data[300];
+    int     i;
+    for (i = 0; i < 300; i++) {
+        original_data[i] = i % 37;
+    }
+    byte_stuffer_segment_t segments[] = {{original_data, 1}, {original_data + 1, 253}, {original_data + 254, 46}};
+    byte_stuffer_send_segments(0, segments, 3);
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(original_data)));
+    for (auto& d : sent_data) {
+        byte_stuffer_recv_byte(1, d);
+    }
+}
+
+TEST_F(ByteStuffer, sends_segments_straight_from_the_callers_buffer) {
+    uint8_t data[600];
+    int     i;
+    for (i = 0; i < 600; i++) {
+        data[i] = i % 37;
+    }
+    source      = data;
+    source_size = sizeof(data);
+    byte_stuffer_segment_t segments[] = {{data, 300}, {data + 300, 300}};
+    byte_stuffer_send_segments(0, segments, 2);
+    // Zeroes are replaced by block codes, every other byte has to be sent from the caller's buffer
+    uint32_t non_zero     = sizeof(data) - std::count(data, data + sizeof(data), 0);
+    uint32_t bytes_copied = non_zero - bytes_from_source;
+    EXPECT_EQ(bytes_copied, 0);
+    // Only the block codes and the frame end are sent from elsewhere
+    EXPECT_EQ(bytes_from_elsewhere, sent_data.size() - non_zero);
+    RecordProperty("payload_bytes", (int)sizeof(data));
+    RecordProperty("bytes_copied", (int)bytes_copied);
+    RecordProperty("overhead_bytes", (int)bytes_from_elsewhere);
+}
+
 TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_small_packet) {
     uint8_t original_data[] = {1, 2, 3};
     byte_stuffer_send_frame(0, original_data, sizeof(original_data));
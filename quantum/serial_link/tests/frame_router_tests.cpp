@@ -47,6 +47,11 @@ class FrameRouter : public testing::Test {
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         auto& buffer = current_router_buffer->send_buffers[link];
         std::copy(data, data + size, std::back_inserter(buffer));
+        if (data >= source && data + size <= source + source_size) {
+            bytes_from_source += size;
+        } else {
+            bytes_from_elsewhere += size;
+        }
     }
 
     void receive_data(uint8_t link, uint8_t* data, uint16_t size) {
@@ -81,6 +86,12 @@ class FrameRouter : public testing::Test {
     router_buffer  router_buffers[8];
     router_buffer* current_router_buffer;
 
+    // Counts where the bytes of sent frames are read from
+    const uint8_t* source               = nullptr;
+    uint16_t       source_size          = 0;
+    uint32_t       bytes_from_source    = 0;
+    uint32_t       bytes_from_elsewhere = 0;
+
     static FrameRouter* Instance;
 };
 
@@ -202,3 +213,20 @@ TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
+
+TEST_F(FrameRouter, sent_frame_is_not_staged_through_another_buffer) {
+    frame_buffer_t data;
+    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    activate_router(0);
+    // The destination id is added after the payload, the crc is sent from the validator's stack
+    source      = (uint8_t*)&data;
+    source_size = 5;
+    router_send_frame(0xFF, (uint8_t*)&data, 4);
+    uint32_t bytes_copied = source_size - bytes_from_source;
+    EXPECT_EQ(bytes_copied, 0);
+    uint32_t sent = router_buffers[0].send_buffers[DOWN_LINK].size();
+    EXPECT_EQ(bytes_from_elsewhere, sent - source_size);
+    RecordProperty("payload_bytes", 4);
+    RecordProperty("bytes_copied", (int)bytes_copied);
+    RecordProperty("bytes_sent", (int)sent);
+}
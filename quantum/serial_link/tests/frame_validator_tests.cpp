@@ -24,8 +24,10 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <vector>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
+#include "serial_link/protocol/byte_stuffer.h"
 }
 
 using testing::_;
@@ -49,7 +51,13 @@ FrameValidator* FrameValidator::Instance = nullptr;
 extern "C" {
 void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size) { FrameValidator::Instance->route_incoming_frame(link, data, size); }
 
-void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) { FrameValidator::Instance->byte_stuffer_send_frame(link, data, size); }
+void byte_stuffer_send_segments(uint8_t link, const byte_stuffer_segment_t* segments, uint8_t num_segments) {
+    std::vector<uint8_t> frame;
+    for (uint8_t i = 0; i < num_segments; i++) {
+        frame.insert(frame.end(), segments[i].data, segments[i].data + segments[i].size);
+    }
+    FrameValidator::Instance->byte_stuffer_send_frame(link, frame.data(), frame.size());
+}
 }
 
 TEST_F(FrameValidator, doesnt_validate_frames_under_5_bytes) {
@@ -98,3 +106,12 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
     EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+
+TEST_F(FrameValidator, sending_does_not_write_to_the_original_buffer) {
+    uint8_t original[] = {1, 2, 3, 4, 5, 0xAA, 0xAA, 0xAA, 0xAA};
+    uint8_t expected[] = {1, 2, 3, 4, 5, 0xF4, 0x99, 0x0B, 0x47};
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
+    validator_send_frame(0, original, 5);
+    uint8_t unchanged[] = {1, 2, 3, 4, 5, 0xAA, 0xAA, 0xAA, 0xAA};
+    EXPECT_THAT(original, ElementsAreArray(unchanged));
+}
@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
 extern "C" {
 #include "serial_link/protocol/triple_buffered_object.h"
 }
@@ -78,3 +80,55 @@ TEST_F(TripleBufferedObject, performs_two_writes_in_the_middle_of_read) {
     EXPECT_EQ(*triple_buffer_read(&test_object), 3);
     EXPECT_EQ(triple_buffer_read(&test_object), nullptr);
 }
+
+struct stress_data {
+    uint32_t values[16];
+};
+
+struct stress_object {
+    uint8_t     state;
+    stress_data buffer[3];
+};
+
+TEST(TripleBufferedObjectThreads, concurrent_reads_are_never_torn) {
+    static stress_object object;
+    triple_buffer_init((triple_buffer_object_t*)&object);
+    const uint32_t    num_writes = 200000;
+    std::atomic<bool> done(false);
+
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= num_writes; i++) {
+            stress_data* data = triple_buffer_begin_write(&object);
+            for (auto& v : data->values) {
+                v = i;
+            }
+            triple_buffer_end_write(&object);
+        }
+        done = true;
+    });
+
+    uint32_t last_read = 0;
+    uint32_t num_torn  = 0;
+    uint32_t num_stale = 0;
+    bool     finished  = false;
+    while (!finished) {
+        finished          = done;
+        stress_data* data = triple_buffer_read(&object);
+        if (data) {
+            uint32_t first = data->values[0];
+            for (auto v : data->values) {
+                if (v != first) {
+                    num_torn++;
+                }
+            }
+            if (first <= last_read) {
+                num_stale++;
+            }
+            last_read = first;
+        }
+    }
+    writer.join();
+    EXPECT_EQ(num_torn, 0);
+    EXPECT_EQ(num_stale, 0);
+    EXPECT_EQ(last_read, num_writes);
+}
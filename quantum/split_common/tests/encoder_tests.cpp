@@ -0,0 +1,131 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <stdlib.h>
+
+extern "C" {
+#include "encoder.h"
+
+uint8_t       test_pins  = 0;
+volatile bool isLeftHand = true;
+
+void last_encoder_activity_trigger(void) {}
+
+// the steps the master got from each encoder: 0 is this half, 1 the other
+int steps_emitted[2];
+int largest_step;
+
+bool encoder_update_delta_user(int8_t index, int8_t steps) {
+    steps_emitted[index] += steps;
+    largest_step = std::max(largest_step, abs(steps));
+    return false;
+}
+}
+
+/* This half plays the slave and loops its counts back into the other half's
+ * encoder, as the master would after a transfer.
+ */
+class SplitEncoder : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() { encoder_init(); }
+
+    void SetUp() override {
+        // settle whatever an earlier test left in flight
+        transfer();
+        transfer();
+        steps_emitted[0] = steps_emitted[1] = 0;
+        largest_step                        = 0;
+    }
+
+    // a full quadrature cycle per detent, read after every edge; positive is clockwise
+    void spin(int detents) {
+        static const uint8_t cycle[] = {0, 1, 3, 2};
+        for (int i = 0; i < abs(detents) * 4; i++) {
+            phase     = (phase + (detents > 0 ? 1 : 3)) % 4;
+            test_pins = cycle[phase];
+            encoder_read();
+        }
+    }
+
+    // slave publishes, master applies, and the master's counts come back unless the ack is lost
+    void transfer(bool ack = true) {
+        encoder_state_raw(slave_state);
+        encoder_update_raw(slave_state);
+        if (ack) {
+            uint8_t ack_state[1];
+            encoder_state_ack_raw(ack_state);
+            encoder_update_ack_raw(ack_state);
+        }
+    }
+
+    uint8_t phase = 0;
+
+    static uint8_t slave_state[1];
+};
+
+uint8_t SplitEncoder::slave_state[1] = {0};
+
+TEST_F(SplitEncoder, FastSpinsArriveOverSeveralTransfers) {
+    spin(300);
+    EXPECT_EQ(steps_emitted[0], 300);
+
+    transfer();
+    EXPECT_EQ(steps_emitted[1], 127);
+    transfer();
+    transfer();
+    EXPECT_EQ(steps_emitted[1], 300);
+    EXPECT_LE(largest_step, 127);
+}
+
+TEST_F(SplitEncoder, LostAcksHoldBackTheRestUntilOneArrives) {
+    spin(200);
+    transfer(false);
+    EXPECT_EQ(steps_emitted[1], 127);
+
+    // without an ack nothing more may be published, however often the transfer repeats
+    spin(100);
+    for (int i = 0; i < 5; i++) {
+        transfer(false);
+    }
+    EXPECT_EQ(steps_emitted[1], 127);
+
+    // the master sends its counts again with the next transfer
+    transfer();
+    transfer();
+    transfer();
+    EXPECT_EQ(steps_emitted[1], 300);
+    EXPECT_LE(largest_step, 127);
+}
+
+TEST_F(SplitEncoder, CountsWrapWithoutLosingSteps) {
+    // several times around the uint8_t counts, changing direction on the way
+    int total = 0;
+    for (int round = 0; round < 8; round++) {
+        int detents = (round % 3 == 2) ? -250 : 250;
+        spin(detents);
+        total += detents;
+        transfer(round % 2 == 0);
+        transfer(false);
+        transfer();
+    }
+    transfer();
+    transfer();
+    EXPECT_EQ(steps_emitted[1], total);
+    EXPECT_EQ(steps_emitted[0], total);
+    EXPECT_LE(largest_step, 127);
+}
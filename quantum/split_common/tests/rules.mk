@@ -0,0 +1,6 @@
+split_encoder_DEFS := -DIGNORE_ATOMIC_BLOCK -DSPLIT_KEYBOARD -DENCODER_ENABLE -DMATRIX_ROWS=2 -DMATRIX_COLS=1 -DENCODERS_PAD_A={0} -DENCODERS_PAD_B={1}
+split_encoder_INC := $(QUANTUM_PATH)/split_common/tests $(QUANTUM_PATH)/split_common
+
+split_encoder_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/encoder_tests.cpp \
+	$(QUANTUM_PATH)/encoder.c
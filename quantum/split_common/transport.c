@@ -50,12 +50,15 @@ typedef struct _I2C_slave_buffer_t {
 #    endif
 #    ifdef ENCODER_ENABLE
     uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    uint8_t encoder_ack[NUMBER_OF_ENCODERS];
 #    endif
 #    ifdef WPM_ENABLE
     uint8_t current_wpm;
 #    endif
 } I2C_slave_buffer_t;
 
+_Static_assert(sizeof(I2C_slave_buffer_t) <= I2C_SLAVE_REG_COUNT, "The split state does not fit into the I2C slave registers, enable fewer split features or encoders");
+
 static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
 
 #    define I2C_SYNC_TIME_START offsetof(I2C_slave_buffer_t, sync_timer)
@@ -67,6 +70,7 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 #    define I2C_BACKLIGHT_START offsetof(I2C_slave_buffer_t, backlight_level)
 #    define I2C_RGB_START offsetof(I2C_slave_buffer_t, rgblight_sync)
 #    define I2C_ENCODER_START offsetof(I2C_slave_buffer_t, encoder_state)
+#    define I2C_ENCODER_ACK_START offsetof(I2C_slave_buffer_t, encoder_ack)
 #    define I2C_WPM_START offsetof(I2C_slave_buffer_t, current_wpm)
 
 #    define TIMEOUT 100
@@ -105,6 +109,14 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    ifdef ENCODER_ENABLE
     i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state), TIMEOUT);
     encoder_update_raw(i2c_buffer->encoder_state);
+
+    uint8_t encoder_ack[NUMBER_OF_ENCODERS];
+    encoder_state_ack_raw(encoder_ack);
+    if (memcmp(encoder_ack, i2c_buffer->encoder_ack, sizeof(encoder_ack)) != 0) {
+        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_ACK_START, (void *)encoder_ack, sizeof(encoder_ack), TIMEOUT) >= 0) {
+            memcpy(i2c_buffer->encoder_ack, encoder_ack, sizeof(encoder_ack));
+        }
+    }
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -172,6 +184,7 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    endif
 
 #    ifdef ENCODER_ENABLE
+    encoder_update_ack_raw(i2c_buffer->encoder_ack);
     encoder_state_raw(i2c_buffer->encoder_state);
 #    endif
 
@@ -226,6 +239,9 @@ typedef struct _Serial_m2s_buffer_t {
 #    ifdef WPM_ENABLE
     uint8_t      current_wpm;
 #    endif
+#    ifdef ENCODER_ENABLE
+    uint8_t      encoder_ack[NUMBER_OF_ENCODERS];
+#    endif
 } Serial_m2s_buffer_t;
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -329,6 +345,7 @@ bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 
 #    ifdef ENCODER_ENABLE
     encoder_update_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+    encoder_state_ack_raw((uint8_t *)serial_m2s_buffer.encoder_ack);
 #    endif
 
 #    ifdef WPM_ENABLE
@@ -367,6 +384,7 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
 #    endif
 
 #    ifdef ENCODER_ENABLE
+    encoder_update_ack_raw((uint8_t *)serial_m2s_buffer.encoder_ack);
     encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
 #    endif
 
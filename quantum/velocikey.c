@@ -1,7 +1,6 @@
 #include "velocikey.h"
 #include "timer.h"
 #include "eeconfig.h"
-#include "eeprom.h"
 
 #ifndef MIN
 #    define MIN(a, b) (((a) < (b)) ? (a) : (b))
@@ -13,13 +12,13 @@
 #define TYPING_SPEED_MAX_VALUE 200
 uint8_t typing_speed = 0;
 
-bool velocikey_enabled(void) { return eeprom_read_byte(EECONFIG_VELOCIKEY) == 1; }
+bool velocikey_enabled(void) { return eeconfig_read_velocikey() == 1; }
 
 void velocikey_toggle(void) {
     if (velocikey_enabled())
-        eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
+        eeconfig_update_velocikey(0);
     else
-        eeprom_update_byte(EECONFIG_VELOCIKEY, 1);
+        eeconfig_update_velocikey(1);
 }
 
 void velocikey_accelerate(void) {
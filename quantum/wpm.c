@@ -17,17 +17,31 @@
 
 #include "wpm.h"
 
+#ifndef MIN
+#    define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#    define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
 // WPM Stuff
-static uint8_t  current_wpm = 0;
-static uint8_t  latest_wpm  = 0;
-static uint16_t wpm_timer   = 0;
+// timestamps of the last WPM_SAMPLES keystrokes, the newest before key_head
+static uint16_t key_times[WPM_SAMPLES];
+static uint8_t  key_head  = 0;
+static uint8_t  key_count = 0;
+static uint16_t wpm_timer = 0;
+
+// in 1/256 WPM, the current WPM scaled up by WPM_SMOOTHING to keep the average's remainder
+static uint16_t burst_wpm       = 0;
+static uint32_t current_wpm_sum = 0;
+
+void set_current_wpm(uint8_t new_wpm) { current_wpm_sum = ((uint32_t)new_wpm << 8) * WPM_SMOOTHING; }
 
-// This smoothing is 40 keystrokes
-static const float wpm_smoothing = 0.0487;
+uint8_t get_current_wpm(void) { return MIN((get_current_wpm_fixed() + 128) >> 8, 0xFF); }
 
-void set_current_wpm(uint8_t new_wpm) { current_wpm = new_wpm; }
+uint16_t get_current_wpm_fixed(void) { return current_wpm_sum / WPM_SMOOTHING; }
 
-uint8_t get_current_wpm(void) { return current_wpm; }
+uint8_t get_burst_wpm(void) { return MIN((burst_wpm + 128) >> 8, 0xFF); }
 
 bool wpm_keycode(uint16_t keycode) { return wpm_keycode_kb(keycode); }
 
@@ -46,19 +60,41 @@ __attribute__((weak)) bool wpm_keycode_user(uint16_t keycode) {
     return false;
 }
 
+/* WPM over the keystrokes in the sliding window. Once the wait for the next
+ * keystroke is longer than the average interval, the rate counts it as if it
+ * came now, so it falls while nothing is typed; keystrokes older than
+ * WPM_WINDOW drop out, so the timestamps never wrap.
+ */
+static uint16_t sliding_window_wpm(uint16_t now) {
+    while (key_count > 0 && TIMER_DIFF_16(now, key_times[(key_head + WPM_SAMPLES - key_count) % WPM_SAMPLES]) > WPM_WINDOW) {
+        key_count--;
+    }
+    if (key_count < 2) {
+        return 0;
+    }
+
+    uint16_t oldest  = key_times[(key_head + WPM_SAMPLES - key_count) % WPM_SAMPLES];
+    uint16_t span    = TIMER_DIFF_16(key_times[(key_head + WPM_SAMPLES - 1) % WPM_SAMPLES], oldest);
+    uint16_t elapsed = MAX(MAX(span, TIMER_DIFF_16(now, oldest) - span / (key_count - 1)), 1);
+    uint32_t wpm     = (key_count - 1) * (60000UL * 256 / WPM_ESTIMATED_WORD_SIZE) / elapsed;
+    return MIN(wpm, 0xFFFF);
+}
+
 void update_wpm(uint16_t keycode) {
     if (wpm_keycode(keycode)) {
-        if (wpm_timer > 0) {
-            latest_wpm  = 60000 / timer_elapsed(wpm_timer) / 5;
-            current_wpm = (latest_wpm - current_wpm) * wpm_smoothing + current_wpm;
-        }
-        wpm_timer = timer_read();
+        uint16_t now        = timer_read();
+        key_times[key_head] = now;
+        key_head            = (key_head + 1) % WPM_SAMPLES;
+        key_count           = MIN(key_count + 1, WPM_SAMPLES);
+        burst_wpm           = sliding_window_wpm(now);
     }
 }
 
 void decay_wpm(void) {
-    if (timer_elapsed(wpm_timer) > 1000) {
-        current_wpm = (0 - current_wpm) * wpm_smoothing + current_wpm;
-        wpm_timer   = timer_read();
+    if (timer_elapsed(wpm_timer) >= WPM_SAMPLE_PERIOD) {
+        wpm_timer = timer_read();
+        burst_wpm = sliding_window_wpm(wpm_timer);
+        // exponential moving average over about WPM_SMOOTHING samples
+        current_wpm_sum += burst_wpm - current_wpm_sum / WPM_SMOOTHING;
     }
 }
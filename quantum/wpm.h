@@ -19,12 +19,34 @@
 
 #include "quantum.h"
 
+// keystrokes the burst rate is measured over
+#ifndef WPM_SAMPLES
+#    define WPM_SAMPLES 16
+#endif
+// ms after which a keystroke no longer counts towards the burst rate
+#ifndef WPM_WINDOW
+#    define WPM_WINDOW 4000
+#endif
+// ms between samples of the burst rate into the current WPM
+#ifndef WPM_SAMPLE_PERIOD
+#    define WPM_SAMPLE_PERIOD 250
+#endif
+// samples the current WPM is averaged over
+#ifndef WPM_SMOOTHING
+#    define WPM_SMOOTHING 16
+#endif
+#ifndef WPM_ESTIMATED_WORD_SIZE
+#    define WPM_ESTIMATED_WORD_SIZE 5
+#endif
+
 bool wpm_keycode(uint16_t keycode);
 bool wpm_keycode_kb(uint16_t keycode);
 bool wpm_keycode_user(uint16_t keycode);
 
-void    set_current_wpm(uint8_t);
-uint8_t get_current_wpm(void);
-void    update_wpm(uint16_t);
+void     set_current_wpm(uint8_t);
+uint8_t  get_current_wpm(void);
+uint16_t get_current_wpm_fixed(void);
+uint8_t  get_burst_wpm(void);
+void     update_wpm(uint16_t);
 
 void decay_wpm(void);
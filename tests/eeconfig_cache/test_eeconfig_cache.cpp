@@ -0,0 +1,83 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "eeconfig.h"
+#include "eeprom.h"
+#include "velocikey.h"
+
+extern uint32_t eeprom_read_count;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class EeconfigCache : public TestFixture {};
+
+TEST_F(EeconfigCache, ScanningDoesNotReadTheEeprom) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    // the first access may load the cache
+    velocikey_enabled();
+    eeprom_read_count = 0;
+
+    idle_for(100);
+    for (int i = 0; i < 20; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+    idle_for(100);
+
+    EXPECT_EQ(eeprom_read_count, 0);
+}
+
+TEST_F(EeconfigCache, VelocikeyToggleWritesThroughAndStaysCached) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    bool enabled = velocikey_enabled();
+
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+
+    EXPECT_NE(velocikey_enabled(), enabled);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_VELOCIKEY), enabled ? 0 : 1);
+
+    eeprom_read_count = 0;
+    for (int i = 0; i < 20; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(eeprom_read_count, 0);
+}
+
+TEST_F(EeconfigCache, ReloadsAfterEeconfigInit) {
+    eeconfig_update_velocikey(1);
+    eeconfig_update_debug(0x0F);
+    eeconfig_init();
+
+    EXPECT_EQ(eeconfig_read_velocikey(), 0);
+    EXPECT_EQ(eeconfig_read_debug(), 0);
+    EXPECT_EQ(eeconfig_read_keymap(), 0);
+}
@@ -0,0 +1,74 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,    KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+// One LED under every key
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    }, {
+        {  0,  0}, { 24,  0}, { 49,  0}, { 74,  0}, { 99,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 24, 21}, { 49, 21}, { 74, 21}, { 99, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 42}, { 24, 42}, { 49, 42}, { 74, 42}, { 99, 42}, {124, 42}, {149, 42}, {174, 42}, {199, 42}, {224, 42},
+        {  0, 64}, { 24, 64}, { 49, 64}, { 74, 64}, { 99, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+
+// clang-format on
+
+// Counts what reaches the driver
+uint8_t  test_led_values[DRIVER_LED_TOTAL];
+uint32_t test_led_writes;
+uint32_t test_led_flushes;
+
+static void init(void) {}
+
+static void set_value(int index, uint8_t value) {
+    test_led_values[index] = value;
+    test_led_writes++;
+}
+
+static void set_value_all(uint8_t value) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) set_value(i, value);
+}
+
+static void flush(void) { test_led_flushes++; }
+
+const led_matrix_driver_t led_matrix_driver = {
+    .init          = init,
+    .set_value     = set_value,
+    .set_value_all = set_value_all,
+    .flush         = flush,
+};
@@ -0,0 +1,148 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "matrix_benchmark.hpp"
+
+extern "C" {
+extern uint8_t  test_led_values[DRIVER_LED_TOTAL];
+extern uint32_t test_led_writes;
+extern uint32_t test_led_flushes;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class LedMatrix : public TestFixture {
+   public:
+    LedMatrix() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        led_matrix_enable_noeeprom();
+        led_matrix_set_value_noeeprom(128);
+        led_matrix_mode(LED_MATRIX_UNIFORM_BRIGHTNESS, false);
+        // let hits of an earlier test fade out
+        idle_for(2000);
+        reset();
+    }
+
+    void reset() { test_led_writes = test_led_flushes = 0; }
+
+    TestDriver driver;
+};
+
+TEST_F(LedMatrix, UnchangedFramesNeverReachTheDriver) {
+    idle_for(1000);
+    EXPECT_EQ(test_led_writes, 0);
+    EXPECT_EQ(test_led_flushes, 0);
+}
+
+TEST_F(LedMatrix, RendersAFrameOverSeveralScans) {
+    led_matrix_disable_noeeprom();
+    idle_for(100);
+    uint8_t frame[DRIVER_LED_TOTAL];
+    memcpy(frame, g_led_render_buffer, sizeof(frame));
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) EXPECT_EQ(frame[i], 0);
+
+    led_matrix_enable_noeeprom();
+    int scans = 0, lit = 0;
+    while (lit < DRIVER_LED_TOTAL && scans < 100) {
+        run_one_scan_loop();
+        scans++;
+        int changed = 0;
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            if (frame[i] != g_led_render_buffer[i]) changed++;
+        }
+        EXPECT_LE(changed, LED_MATRIX_LED_PROCESS_LIMIT);
+        memcpy(frame, g_led_render_buffer, sizeof(frame));
+        lit += changed;
+    }
+    EXPECT_EQ(lit, DRIVER_LED_TOTAL);
+    EXPECT_GT(scans, 1);
+}
+
+TEST_F(LedMatrix, ReactiveEffectOnlyWritesTheHitLed) {
+    led_matrix_mode(LED_MATRIX_SOLID_REACTIVE_SIMPLE, false);
+    idle_for(100);
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) EXPECT_EQ(test_led_values[i], 0);
+    reset();
+
+    press_key(0, 0);
+    idle_for(50);
+    release_key(0, 0);
+    idle_for(50);
+    EXPECT_GT(test_led_values[0], 0);
+    for (int i = 1; i < DRIVER_LED_TOTAL; i++) EXPECT_EQ(test_led_values[i], 0);
+    EXPECT_EQ(test_led_writes, test_led_flushes);
+
+    idle_for(1100);
+    EXPECT_EQ(test_led_values[0], 0);
+}
+
+// A frame is rendered over several scans from the hits recorded when it
+// started, so it must come out the same as rendering every LED at once.
+TEST_F(LedMatrix, FrameSpreadOverScansMatchesAFullRender) {
+    led_matrix_mode(LED_MATRIX_SOLID_REACTIVE_SIMPLE, false);
+    idle_for(100);
+    for (uint8_t key = 0; key < 4; key++) {
+        press_key(key * 3, key % MATRIX_ROWS);
+        run_one_scan_loop();
+        release_key(key * 3, key % MATRIX_ROWS);
+        idle_for(60);
+    }
+
+    uint32_t frames = 0;
+    for (int scans = 0; scans < 200 && frames < 5; scans++) {
+        uint32_t flushes = test_led_flushes;
+        run_one_scan_loop();
+        if (test_led_flushes == flushes) continue;
+        frames++;
+
+        // the reactive runner and SOLID_REACTIVE_SIMPLE_math for every LED at once
+        uint8_t speed = led_matrix_eeconfig.speed;
+        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+            uint16_t tick = 1023 >> speed;
+            for (int8_t j = g_last_hit_tracker.count - 1; j >= 0; j--) {
+                if (g_last_hit_tracker.index[j] == i && g_last_hit_tracker.tick[j] < tick) {
+                    tick = g_last_hit_tracker.tick[j];
+                    break;
+                }
+            }
+            uint8_t offset   = (tick << speed) >> 2;
+            uint8_t expected = ((255 - offset) * led_matrix_eeconfig.val) >> 8;
+            EXPECT_EQ(g_led_render_buffer[i], expected) << "led " << (int)i;
+            EXPECT_EQ(test_led_values[i], expected) << "led " << (int)i;
+        }
+    }
+    EXPECT_EQ(frames, 5);
+    RecordProperty("flushes", test_led_flushes);
+    RecordProperty("led_writes", test_led_writes);
+}
+
+// Renders a reactive effect while typing, with the same LED count and key hits
+// for led_matrix and rgb_matrix, and records the cost of a task call.
+TEST_F(LedMatrix, Benchmark) {
+    led_matrix_mode(LED_MATRIX_SOLID_REACTIVE_SIMPLE, false);
+    idle_for(100);
+    reset();
+
+    matrix_benchmark_t result = run_matrix_benchmark(led_matrix_task, process_led_matrix);
+    RecordProperty("leds", DRIVER_LED_TOTAL);
+    RecordProperty("ns_per_task", result.ns_per_task);
+    RecordProperty("worst_ns", result.worst_ns);
+    RecordProperty("flushes", test_led_flushes);
+    RecordProperty("led_writes", test_led_writes);
+    EXPECT_GT(test_led_flushes, 0);
+}
@@ -0,0 +1,104 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "mousekey.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+class MousekeyInertia : public TestFixture {
+   public:
+    MousekeyInertia() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) {
+            x += report.x;
+            reports++;
+        }));
+    }
+
+    // Runs the keyboard task every 'period' ms for 'duration' ms
+    void run_every(unsigned period, unsigned duration) {
+        for (unsigned elapsed = 0; elapsed < duration; elapsed += period) {
+            keyboard_task();
+            advance_time(period);
+        }
+    }
+
+    void reset() { x = reports = 0; }
+
+    TestDriver driver;
+    int        x = 0, reports = 0;
+};
+
+TEST_F(MousekeyInertia, EasesTowardsBaseSpeed) {
+    press_key(0, 0);
+    idle_for(MOUSEKEY_DELAY + MOUSEKEY_ACCELERATION_TIME);
+    reset();
+    // a time constant in, 1 - 1/e of the way from 100 to 1000 px/s
+    idle_for(100);
+    EXPECT_GT(x, 60);
+    EXPECT_LT(x, 90);
+
+    idle_for(5 * MOUSEKEY_ACCELERATION_TIME);
+    reset();
+    idle_for(1000);
+    EXPECT_NEAR(x, MOUSEKEY_BASE_SPEED, 20);
+
+    release_key(0, 0);
+    idle_for(1000);
+}
+
+TEST_F(MousekeyInertia, CoastsAfterRelease) {
+    for (unsigned period : {1, 10, 30}) {
+        press_key(0, 0);
+        run_every(period, MOUSEKEY_DELAY + 6 * MOUSEKEY_ACCELERATION_TIME);
+        release_key(0, 0);
+        reset();
+
+        // friction stops 1000 px/s within 1000 px/s * 100 ms
+        run_every(period, 10 * MOUSEKEY_FRICTION_TIME);
+        EXPECT_NEAR(x, MOUSEKEY_BASE_SPEED * MOUSEKEY_FRICTION_TIME / 1000, 5) << "every " << period << " ms";
+
+        reset();
+        run_every(period, 1000);
+        EXPECT_EQ(reports, 0) << "every " << period << " ms";
+    }
+}
+
+TEST_F(MousekeyInertia, TurnsAroundThroughFriction) {
+    press_key(0, 0);
+    idle_for(MOUSEKEY_DELAY + 6 * MOUSEKEY_ACCELERATION_TIME);
+    release_key(0, 0);
+    press_key(2, 0);
+    run_one_scan_loop();
+    reset();
+
+    // still moving right for a bit, then left
+    idle_for(50);
+    EXPECT_GT(x, 0);
+    idle_for(2000);
+    EXPECT_LT(x, -500);
+
+    release_key(2, 0);
+    idle_for(1000);
+}
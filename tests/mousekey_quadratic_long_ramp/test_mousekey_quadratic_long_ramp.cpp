@@ -0,0 +1,58 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "mousekey.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+class MousekeyQuadraticLongRamp : public TestFixture {
+   public:
+    MousekeyQuadraticLongRamp() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) { x += report.x; }));
+    }
+
+    TestDriver driver;
+    int        x = 0;
+};
+
+TEST_F(MousekeyQuadraticLongRamp, RampsUpOverTheWholeAccelerationTime) {
+    press_key(0, 0);
+    idle_for(MOUSEKEY_DELAY);
+    x = 0;
+
+    // from 100 to 1000 px/s over 20 s, quadratically: 100 px/s * 20 s + 900 px/s * 20 s / 3
+    int total = 0, last = 0;
+    for (int second = 0; second < MOUSEKEY_ACCELERATION_TIME / 1000; second++) {
+        idle_for(1000);
+        EXPECT_GE(x, last) << "in second " << second;
+        EXPECT_LE(x, MOUSEKEY_BASE_SPEED + MOUSEKEY_BASE_SPEED * MOUSEKEY_INTERVAL / 1000) << "in second " << second;
+        total += x;
+        last = x;
+        x    = 0;
+    }
+    EXPECT_NEAR(total, 8000, 100);
+
+    release_key(0, 0);
+    idle_for(100);
+}
@@ -0,0 +1,140 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "mousekey.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+class MousekeySubpixel : public TestFixture {
+   public:
+    MousekeySubpixel() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) {
+            x += report.x;
+            y += report.y;
+            v += report.v;
+            reports++;
+        }));
+    }
+
+    // Runs the keyboard task every 'period' ms for 'duration' ms
+    void run_every(unsigned period, unsigned duration) {
+        for (unsigned elapsed = 0; elapsed < duration; elapsed += period) {
+            keyboard_task();
+            advance_time(period);
+        }
+    }
+
+    void reset() { x = y = v = reports = 0; }
+
+    TestDriver driver;
+    int        x = 0, y = 0, v = 0, reports = 0;
+};
+
+TEST_F(MousekeySubpixel, FirstStepThenDelay) {
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(x, MOUSEKEY_MOVE_DELTA);
+
+    idle_for(MOUSEKEY_DELAY - 2);
+    EXPECT_EQ(x, MOUSEKEY_MOVE_DELTA);
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(MousekeySubpixel, LinearRampToBaseSpeed) {
+    press_key(0, 0);
+    run_one_scan_loop();
+    idle_for(MOUSEKEY_DELAY - 1);
+    reset();
+
+    // from 100 to 1000 px/s over the first second: 550 px
+    idle_for(MOUSEKEY_ACCELERATION_TIME);
+    EXPECT_NEAR(x, 550, 20);
+
+    reset();
+    idle_for(1000);
+    EXPECT_NEAR(x, MOUSEKEY_BASE_SPEED, MOUSEKEY_BASE_SPEED * MOUSEKEY_INTERVAL / 1000 + 1);
+    EXPECT_EQ(y, 0);
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(MousekeySubpixel, SpeedDoesNotDependOnTheTaskRate) {
+    for (unsigned period : {1, 3, 7, 16, 25, 50}) {
+        press_key(0, 0);
+        run_every(period, MOUSEKEY_DELAY + MOUSEKEY_ACCELERATION_TIME);
+        reset();
+
+        run_every(period, 10000);
+        EXPECT_NEAR(x, MOUSEKEY_BASE_SPEED * 10, 20) << "every " << period << " ms";
+        EXPECT_LE(reports, 10000 / MOUSEKEY_INTERVAL + 1) << "every " << period << " ms";
+
+        release_key(0, 0);
+        run_every(period, 100);
+    }
+}
+
+TEST_F(MousekeySubpixel, DiagonalKeepsFractions) {
+    press_key(4, 0);
+    press_key(0, 0);
+    press_key(1, 0);
+    idle_for(MOUSEKEY_DELAY + 100);
+    reset();
+
+    // 400 px/s / sqrt(2) are 282.8 px/s on each axis, 4.5 px per report
+    run_every(5, 10000);
+    EXPECT_NEAR(x, 2828, 10);
+    EXPECT_NEAR(y, 2828, 10);
+
+    release_key(1, 0);
+    release_key(0, 0);
+    release_key(4, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(MousekeySubpixel, SlowWheelSpeed) {
+    for (unsigned period : {1, 40}) {
+        press_key(3, 0);
+        run_every(period, MOUSEKEY_WHEEL_DELAY + MOUSEKEY_WHEEL_ACCELERATION_TIME);
+        reset();
+
+        run_every(period, 10000);
+        EXPECT_NEAR(v, -MOUSEKEY_WHEEL_BASE_MOVEMENTS * 10, 1) << "every " << period << " ms";
+
+        release_key(3, 0);
+        run_every(period, 100);
+    }
+}
+
+TEST_F(MousekeySubpixel, StopsOnRelease) {
+    press_key(0, 0);
+    idle_for(2000);
+    release_key(0, 0);
+    run_one_scan_loop();
+    reset();
+
+    idle_for(1000);
+    EXPECT_EQ(reports, 0);
+}
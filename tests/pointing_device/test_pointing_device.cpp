@@ -0,0 +1,101 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <cstdlib>
+
+extern "C" {
+#include "pointing_device.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+class PointingDevice : public TestFixture {
+   public:
+    PointingDevice() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) {
+            x += report.x;
+            y += report.y;
+            v += report.v;
+            largest = std::max(largest, std::abs(report.x));
+            buttons = report.buttons;
+            reports++;
+        }));
+        // send what an earlier test left behind
+        idle_for(1000);
+        reset();
+    }
+
+    void reset() { x = y = v = largest = reports = 0; }
+
+    TestDriver driver;
+    int        x = 0, y = 0, v = 0, largest = 0, reports = 0;
+    uint8_t    buttons = 0;
+};
+
+TEST_F(PointingDevice, SplitsFastMotionAcrossReports) {
+    pointing_device_add_motion(1000, -300, 0, 0);
+    idle_for(POINTING_DEVICE_REPORT_INTERVAL * 10);
+    EXPECT_EQ(x, 1000);
+    EXPECT_EQ(y, -300);
+    EXPECT_EQ(largest, std::min(1000, MOUSE_REPORT_XY_MAX));
+    EXPECT_EQ(reports, (1000 + MOUSE_REPORT_XY_MAX - 1) / MOUSE_REPORT_XY_MAX);
+}
+
+TEST_F(PointingDevice, CoalescesMotionPerPollingInterval) {
+    for (int i = 0; i < 200; i++) {
+        pointing_device_add_motion(3, 0, 0, 0);
+        run_one_scan_loop();
+    }
+    idle_for(POINTING_DEVICE_REPORT_INTERVAL);
+    EXPECT_EQ(x, 600);
+    EXPECT_LE(reports, 200 / POINTING_DEVICE_REPORT_INTERVAL + 1);
+}
+
+TEST_F(PointingDevice, AddsUpMotionSetInTheReport) {
+    for (int i = 0; i < 50; i++) {
+        report_mouse_t report = pointing_device_get_report();
+        report.y              = 100;
+        pointing_device_set_report(report);
+        run_one_scan_loop();
+    }
+    idle_for(1000);
+    EXPECT_EQ(y, 5000);
+}
+
+TEST_F(PointingDevice, SendsNoEmptyReports) {
+    idle_for(1000);
+    EXPECT_EQ(reports, 0);
+}
+
+TEST_F(PointingDevice, SendsButtonsRightAway) {
+    pointing_device_add_motion(5, 0, 0, 0);
+    run_one_scan_loop();
+    pointing_device_add_motion(7, 0, 0, 0);
+    press_key(0, 0);
+    run_one_scan_loop();
+    // the click goes out with the motion before it
+    EXPECT_EQ(buttons, MOUSE_BTN1);
+    EXPECT_EQ(x, 12);
+
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(buttons, 0);
+}
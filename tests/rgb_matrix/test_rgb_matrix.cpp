@@ -0,0 +1,155 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "matrix_benchmark.hpp"
+
+extern "C" {
+extern RGB      test_led_values[DRIVER_LED_TOTAL];
+extern uint32_t test_led_writes;
+extern uint32_t test_led_flushes;
+extern bool     test_indicator;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class RgbMatrix : public TestFixture {
+   public:
+    RgbMatrix() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        // let hits of an earlier test fade out
+        idle_for(2000);
+        reset();
+    }
+
+    ~RgbMatrix() { test_indicator = false; }
+
+    void reset() { test_led_writes = test_led_flushes = 0; }
+
+    TestDriver driver;
+};
+
+TEST_F(RgbMatrix, UnchangedFramesNeverReachTheDriver) {
+    idle_for(1000);
+    EXPECT_EQ(test_led_writes, 0);
+    EXPECT_EQ(test_led_flushes, 0);
+}
+
+TEST_F(RgbMatrix, DriverGetsTheRenderedFrame) {
+    rgb_matrix_sethsv_noeeprom(85, 255, 128);
+    idle_for(100);
+    EXPECT_EQ(test_led_flushes, 1);
+    EXPECT_EQ(test_led_writes, DRIVER_LED_TOTAL);
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(test_led_values[i].r, g_rgb_render_buffer[i].r);
+        EXPECT_EQ(test_led_values[i].g, g_rgb_render_buffer[i].g);
+        EXPECT_EQ(test_led_values[i].b, g_rgb_render_buffer[i].b);
+        EXPECT_GT(test_led_values[i].g, 0);
+    }
+}
+
+TEST_F(RgbMatrix, IndicatorsAreDrawnOverTheSameFrame) {
+    rgb_matrix_sethsv_noeeprom(85, 255, 128);
+    test_indicator = true;
+    idle_for(100);
+    // the effect and the indicator reach the driver as one frame, and every LED is sent once
+    EXPECT_EQ(test_led_flushes, 1);
+    EXPECT_EQ(test_led_writes, DRIVER_LED_TOTAL);
+    EXPECT_EQ(test_led_values[0].r, 255);
+    EXPECT_EQ(test_led_values[0].g, 0);
+    EXPECT_EQ(test_led_values[0].b, 0);
+    for (int i = 1; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_GT(test_led_values[i].g, 0);
+    }
+
+    // an indicator that keeps drawing the same thing leaves the frame unchanged
+    reset();
+    idle_for(1000);
+    EXPECT_EQ(test_led_flushes, 0);
+
+    // turning it off changes the frame, so it is sent again
+    test_indicator = false;
+    idle_for(100);
+    EXPECT_EQ(test_led_flushes, 1);
+    EXPECT_EQ(test_led_values[0].g, test_led_values[1].g);
+}
+
+TEST_F(RgbMatrix, ReactiveEffectOnlyFlushesWhileAHitFades) {
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+    idle_for(2000);
+    reset();
+
+    press_key(0, 0);
+    idle_for(50);
+    release_key(0, 0);
+    uint32_t frames = 0;
+    while (test_led_flushes > frames && frames < 1000) {
+        frames = test_led_flushes;
+        idle_for(100);
+    }
+    EXPECT_GT(test_led_flushes, 1);
+    // every flush carries a whole frame, and nothing is flushed once the hit has faded
+    EXPECT_EQ(test_led_writes, test_led_flushes * DRIVER_LED_TOTAL);
+    RecordProperty("flushes", test_led_flushes);
+    RecordProperty("led_writes", test_led_writes);
+
+    reset();
+    idle_for(1000);
+    EXPECT_EQ(test_led_flushes, 0);
+}
+
+TEST_F(RgbMatrix, FramesWithinTheCurrentBudgetAreSentAsTheyAre) {
+    rgb_matrix_sethsv_noeeprom(0, 0, 200);
+    idle_for(100);
+    // 40 LEDs at 3 * 200 stay below the budget of 25500
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(test_led_values[i].r, g_rgb_render_buffer[i].r);
+        EXPECT_EQ(test_led_values[i].g, g_rgb_render_buffer[i].g);
+        EXPECT_EQ(test_led_values[i].b, g_rgb_render_buffer[i].b);
+    }
+}
+
+TEST_F(RgbMatrix, FramesOverTheCurrentBudgetAreDimmed) {
+    rgb_matrix_sethsv_noeeprom(0, 0, 255);
+    idle_for(100);
+    // 40 LEDs in white draw 30600 of 25500, a scale of 213/256
+    uint8_t white = g_rgb_render_buffer[0].r;
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(g_rgb_render_buffer[i].r, white);
+        EXPECT_EQ(test_led_values[i].r, (white * 213) >> 8);
+        EXPECT_EQ(test_led_values[i].g, (white * 213) >> 8);
+        EXPECT_EQ(test_led_values[i].b, (white * 213) >> 8);
+    }
+}
+
+// Renders a reactive effect while typing, with the same LED count and key hits
+// for led_matrix and rgb_matrix, and records the cost of a task call.
+TEST_F(RgbMatrix, Benchmark) {
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+    idle_for(100);
+    reset();
+
+    matrix_benchmark_t result = run_matrix_benchmark(rgb_matrix_task, process_rgb_matrix);
+    RecordProperty("leds", DRIVER_LED_TOTAL);
+    RecordProperty("ns_per_task", result.ns_per_task);
+    RecordProperty("worst_ns", result.worst_ns);
+    RecordProperty("flushes", test_led_flushes);
+    RecordProperty("led_writes", test_led_writes);
+    EXPECT_GT(test_led_flushes, 0);
+}
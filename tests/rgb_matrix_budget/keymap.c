@@ -0,0 +1,93 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,    KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+// One LED under every key
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    }, {
+        {  0,  0}, { 24,  0}, { 49,  0}, { 74,  0}, { 99,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 24, 21}, { 49, 21}, { 74, 21}, { 99, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 42}, { 24, 42}, { 49, 42}, { 74, 42}, { 99, 42}, {124, 42}, {149, 42}, {174, 42}, {199, 42}, {224, 42},
+        {  0, 64}, { 24, 64}, { 49, 64}, { 74, 64}, { 99, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+
+// clang-format on
+
+// Rendering takes no time on the host, so every render iteration is charged a
+// simulated cost per LED. It is counted on a microsecond render clock, and on
+// the fake timer which only moves in whole milliseconds, each carrying its
+// remainder over to the next iteration.
+uint32_t        test_render_ns_per_led;
+static uint32_t render_clock_us;
+static uint32_t render_clock_ns;
+static uint32_t render_ns;
+
+void advance_time(uint32_t ms);
+
+uint32_t test_render_clock(void) { return render_clock_us; }
+
+void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    render_clock_ns += test_render_ns_per_led * (led_max - led_min);
+    render_clock_us += render_clock_ns / 1000;
+    render_clock_ns %= 1000;
+
+    render_ns += test_render_ns_per_led * (led_max - led_min);
+    advance_time(render_ns / 1000000);
+    render_ns %= 1000000;
+}
+
+// Counts what reaches the driver
+RGB      test_led_values[DRIVER_LED_TOTAL];
+uint32_t test_led_flushes;
+
+static void init(void) {}
+
+static void set_color(int index, uint8_t red, uint8_t green, uint8_t blue) { test_led_values[index] = (RGB){.r = red, .g = green, .b = blue}; }
+
+static void set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) set_color(i, red, green, blue);
+}
+
+static void flush(void) { test_led_flushes++; }
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = init,
+    .flush         = flush,
+    .set_color     = set_color,
+    .set_color_all = set_color_all,
+};
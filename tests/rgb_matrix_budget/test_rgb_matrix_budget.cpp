@@ -0,0 +1,111 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern RGB      test_led_values[DRIVER_LED_TOTAL];
+extern uint32_t test_led_flushes;
+extern uint32_t test_render_ns_per_led;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class RgbMatrixBudget : public TestFixture {
+   public:
+    RgbMatrixBudget() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        test_render_ns_per_led = 0;
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        idle_for(100);
+    }
+
+    // Finishes the frame in progress, then renders one more from a blank driver
+    void render_frame(RGB* frame) {
+        for (uint8_t i = 0; i < 2; i++) {
+            memset(test_led_values, 0x55, sizeof(test_led_values));
+            uint32_t flushes = test_led_flushes;
+            for (int scans = 0; test_led_flushes == flushes && scans < 1000; scans++) run_one_scan_loop();
+            ASSERT_EQ(test_led_flushes, flushes + 1);
+        }
+        memcpy(frame, test_led_values, sizeof(test_led_values));
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(RgbMatrixBudget, FractionalMicrosecondCostsAreNotRoundedDown) {
+    // 50us fits 26 LEDs at 1.9us each, where a whole microsecond cost would allow all 40
+    test_render_ns_per_led = 1900;
+    idle_for(10000);
+    EXPECT_EQ(g_rgb_led_process_limit, 26);
+    EXPECT_NEAR(rgb_matrix_get_led_cost(RGB_MATRIX_SOLID_COLOR), 1900, 10);
+    RecordProperty("led_cost_ns", rgb_matrix_get_led_cost(RGB_MATRIX_SOLID_COLOR));
+    RecordProperty("leds_per_iteration", g_rgb_led_process_limit);
+}
+
+TEST_F(RgbMatrixBudget, EffectsKeepTheirCostAcrossModeChanges) {
+    test_render_ns_per_led = 1900;
+    idle_for(10000);
+    uint8_t limit = g_rgb_led_process_limit;
+    EXPECT_LT(limit, DRIVER_LED_TOTAL);
+
+    // a free effect renders the whole frame at once...
+    test_render_ns_per_led = 0;
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_ALPHAS_MODS);
+    idle_for(10000);
+    EXPECT_EQ(g_rgb_led_process_limit, DRIVER_LED_TOTAL);
+    EXPECT_EQ(rgb_matrix_get_led_cost(RGB_MATRIX_SOLID_COLOR) > 0, true);
+
+    // ...and coming back starts from the limit measured before, not the default
+    test_render_ns_per_led = 1900;
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+    idle_for(100);
+    EXPECT_EQ(g_rgb_led_process_limit, limit);
+}
+
+// The process limit is a variable here, so the same frame can be rendered in
+// one go and spread over many task runs. With the speed at 0 the effect time
+// and the fading of key hits stand still, so both renders must agree.
+TEST_F(RgbMatrixBudget, IncrementalFramesMatchAFullRender) {
+    rgb_matrix_set_speed_noeeprom(0);
+    for (uint8_t i = 0; i < 4; i++) {
+        process_rgb_matrix(i, i * 3, true);
+        process_rgb_matrix(i, i * 3, false);
+    }
+
+    for (uint8_t mode = 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        // these pick random LEDs every frame
+        if (mode == RGB_MATRIX_RAINDROPS || mode == RGB_MATRIX_JELLYBEAN_RAINDROPS || mode == RGB_MATRIX_DIGITAL_RAIN) continue;
+
+        rgb_matrix_mode_noeeprom(mode);
+        idle_for(100);
+
+        RGB full[DRIVER_LED_TOTAL], incremental[DRIVER_LED_TOTAL];
+        g_rgb_led_process_limit = DRIVER_LED_TOTAL;
+        render_frame(full);
+        g_rgb_led_process_limit = 3;
+        render_frame(incremental);
+
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            EXPECT_EQ(incremental[i].r, full[i].r) << "mode " << (int)mode << " led " << i;
+            EXPECT_EQ(incremental[i].g, full[i].g) << "mode " << (int)mode << " led " << i;
+            EXPECT_EQ(incremental[i].b, full[i].b) << "mode " << (int)mode << " led " << i;
+        }
+    }
+    rgb_matrix_set_speed_noeeprom(UINT8_MAX / 2);
+}
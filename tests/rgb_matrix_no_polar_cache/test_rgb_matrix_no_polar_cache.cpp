@@ -0,0 +1,36 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "../rgb_matrix_runners/reference_frames.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+class RgbMatrixNoPolarCache : public TestFixture {
+   public:
+    RgbMatrixNoPolarCache() { EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()); }
+
+    TestDriver driver;
+};
+
+#ifdef RGB_MATRIX_POLAR_CACHE
+#    error "RGB_MATRIX_NO_POLAR_CACHE did not turn the polar cache off"
+#endif
+
+// Computing the polar coordinates per LED must render the same frames as
+// reading them from the cache, which the runner harness checks
+TEST_F(RgbMatrixNoPolarCache, FramesMatchTheReferenceRunners) { expect_reference_frames(); }
@@ -0,0 +1,118 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+// One LED under every key
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+        {40, 41, 42, 43, 44, 45, 46, 47, 48, 49},
+        {50, 51, 52, 53, 54, 55, 56, 57, 58, 59},
+        {60, 61, 62, 63, 64, 65, 66, 67, 68, 69},
+        {70, 71, 72, 73, 74, 75, 76, 77, 78, 79},
+        {80, 81, 82, 83, 84, 85, 86, 87, 88, 89},
+        {90, 91, 92, 93, 94, 95, 96, 97, 98, 99},
+    }, {
+        {  0,  0}, { 24,  0}, { 49,  0}, { 74,  0}, { 99,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0,  7}, { 24,  7}, { 49,  7}, { 74,  7}, { 99,  7}, {124,  7}, {149,  7}, {174,  7}, {199,  7}, {224,  7},
+        {  0, 14}, { 24, 14}, { 49, 14}, { 74, 14}, { 99, 14}, {124, 14}, {149, 14}, {174, 14}, {199, 14}, {224, 14},
+        {  0, 21}, { 24, 21}, { 49, 21}, { 74, 21}, { 99, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 28}, { 24, 28}, { 49, 28}, { 74, 28}, { 99, 28}, {124, 28}, {149, 28}, {174, 28}, {199, 28}, {224, 28},
+        {  0, 35}, { 24, 35}, { 49, 35}, { 74, 35}, { 99, 35}, {124, 35}, {149, 35}, {174, 35}, {199, 35}, {224, 35},
+        {  0, 42}, { 24, 42}, { 49, 42}, { 74, 42}, { 99, 42}, {124, 42}, {149, 42}, {174, 42}, {199, 42}, {224, 42},
+        {  0, 49}, { 24, 49}, { 49, 49}, { 74, 49}, { 99, 49}, {124, 49}, {149, 49}, {174, 49}, {199, 49}, {224, 49},
+        {  0, 56}, { 24, 56}, { 49, 56}, { 74, 56}, { 99, 56}, {124, 56}, {149, 56}, {174, 56}, {199, 56}, {224, 56},
+        {  0, 64}, { 24, 64}, { 49, 64}, { 74, 64}, { 99, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64}
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    }
+};
+
+// Effect names in enum order, for reporting
+const char *test_effect_names[] = {
+    "NONE",
+#define RGB_MATRIX_EFFECT(name, ...) #name,
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+// clang-format on
+
+// Counts what reaches the driver, and folds every flushed frame into an FNV-1a hash
+uint32_t test_led_writes;
+uint32_t test_led_flushes;
+uint32_t test_frame_hash;
+
+static RGB leds[DRIVER_LED_TOTAL];
+
+static void init(void) {}
+
+static void set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    leds[index] = (RGB){.r = red, .g = green, .b = blue};
+    test_led_writes++;
+}
+
+static void set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        leds[i] = (RGB){.r = red, .g = green, .b = blue};
+    }
+    test_led_writes += DRIVER_LED_TOTAL;
+}
+
+static void flush(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        test_frame_hash = (test_frame_hash ^ leds[i].r) * 16777619;
+        test_frame_hash = (test_frame_hash ^ leds[i].g) * 16777619;
+        test_frame_hash = (test_frame_hash ^ leds[i].b) * 16777619;
+    }
+    test_led_flushes++;
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = init,
+    .flush         = flush,
+    .set_color     = set_color,
+    .set_color_all = set_color_all,
+};
@@ -0,0 +1,118 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "quantum.h"
+extern const char *test_effect_names[];
+extern uint32_t    test_led_flushes;
+extern uint32_t    test_frame_hash;
+void               set_time(uint32_t t);
+void               advance_time(uint32_t ms);
+}
+
+// Renders 100 frames of an effect from a fixed time, seed and set of key
+// hits, and returns the hash of every frame flushed to the driver.
+static uint32_t render_frames(uint8_t mode) {
+    set_time(0x10000);
+    rgb_matrix_init();
+    rgb_matrix_task();
+
+    srand(1);
+    rgb_matrix_mode_noeeprom(mode);
+    for (uint8_t i = 0; i < 8; i++) {
+        process_rgb_matrix(i, i * 3 % 10, true);
+        process_rgb_matrix(i, i * 3 % 10, false);
+        advance_time(40);
+        rgb_matrix_task();
+    }
+
+    test_frame_hash  = 2166136261;
+    uint32_t flushes = test_led_flushes;
+    while (test_led_flushes - flushes < 100) {
+        rgb_matrix_task();
+        advance_time(7);
+    }
+    return test_frame_hash;
+}
+
+// Frame hashes of every effect, taken with the runners as they were before
+// their per-LED math was inlined. The inlined runners, the polar cache and any
+// later change to them must render the same frames. Run the test with
+// PRINT_REFERENCE_FRAMES set to print the hashes of the current tree.
+// clang-format off
+static const std::map<std::string, uint32_t> reference_frames = {
+    {"SOLID_COLOR", 0x81F413B5},
+    {"ALPHAS_MODS", 0x81F413B5},
+    {"GRADIENT_UP_DOWN", 0x415A8BC5},
+    {"GRADIENT_LEFT_RIGHT", 0xF4D13E75},
+    {"BREATHING", 0xA2EB9155},
+    {"BAND_SAT", 0x4986678D},
+    {"BAND_VAL", 0x47945831},
+    {"BAND_PINWHEEL_SAT", 0x70EFBC49},
+    {"BAND_PINWHEEL_VAL", 0xBF3B87B9},
+    {"BAND_SPIRAL_SAT", 0x56B94D65},
+    {"BAND_SPIRAL_VAL", 0x47DE41C8},
+    {"CYCLE_ALL", 0x6BF5C525},
+    {"CYCLE_LEFT_RIGHT", 0x3B210491},
+    {"CYCLE_UP_DOWN", 0x5084BF79},
+    {"RAINBOW_MOVING_CHEVRON", 0x4CD7FFBD},
+    {"CYCLE_OUT_IN", 0xA9FA5ADB},
+    {"CYCLE_OUT_IN_DUAL", 0x44536501},
+    {"CYCLE_PINWHEEL", 0xC0292503},
+    {"CYCLE_SPIRAL", 0x55889ABD},
+    {"DUAL_BEACON", 0xF021D50D},
+    {"RAINBOW_BEACON", 0x7CC36673},
+    {"RAINBOW_PINWHEELS", 0xAE3DEC79},
+    {"RAINDROPS", 0x650AA7D5},
+    {"JELLYBEAN_RAINDROPS", 0x369E100D},
+    {"TYPING_HEATMAP", 0x5A1DABB5},
+    {"DIGITAL_RAIN", 0xB96AA6E4},
+    {"SOLID_REACTIVE_SIMPLE", 0x9A5B8977},
+    {"SOLID_REACTIVE", 0x8E4DE789},
+    {"SOLID_REACTIVE_WIDE", 0x00AC3E43},
+    {"SOLID_REACTIVE_MULTIWIDE", 0x9D1D6E5E},
+    {"SOLID_REACTIVE_CROSS", 0xE972696E},
+    {"SOLID_REACTIVE_MULTICROSS", 0xBBBF7546},
+    {"SOLID_REACTIVE_NEXUS", 0x756AAD6C},
+    {"SOLID_REACTIVE_MULTINEXUS", 0xC5952C03},
+    {"SPLASH", 0x74FB7204},
+    {"MULTISPLASH", 0x765DA9C6},
+    {"SOLID_SPLASH", 0xD155D682},
+    {"SOLID_MULTISPLASH", 0xFAA72F24},
+};
+// clang-format on
+
+// Checks every effect against its reference frames
+static void expect_reference_frames(void) {
+    for (uint8_t mode = 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        uint32_t hash = render_frames(mode);
+        if (getenv("PRINT_REFERENCE_FRAMES")) printf("    {\"%s\", 0x%08X},\n", test_effect_names[mode], hash);
+        auto reference = reference_frames.find(test_effect_names[mode]);
+        if (reference == reference_frames.end()) {
+            ADD_FAILURE() << test_effect_names[mode] << " has no reference frames";
+            continue;
+        }
+        EXPECT_EQ(hash, reference->second) << test_effect_names[mode];
+    }
+}
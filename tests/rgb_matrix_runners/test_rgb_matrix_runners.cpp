@@ -0,0 +1,69 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "reference_frames.hpp"
+#include <chrono>
+#include <string>
+
+extern "C" {
+extern const char *test_effect_names[];
+extern uint32_t    test_led_writes;
+extern uint32_t    test_led_flushes;
+void               advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class RgbMatrixRunners : public TestFixture {
+   public:
+    RgbMatrixRunners() { EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()); }
+
+    TestDriver driver;
+};
+
+TEST_F(RgbMatrixRunners, FramesMatchTheReferenceRunners) { expect_reference_frames(); }
+
+// Renders every effect on 100 LEDs with 8 recorded key hits and records the
+// best time per frame over 200 frames, which is the time per LED in hundredths
+// of a nanosecond. Every LED is rendered in one iteration, so the task calls
+// that write to the driver are the ones that render a frame.
+TEST_F(RgbMatrixRunners, CostPerLed) {
+    for (uint8_t mode = 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        // hits expire after a minute, so every effect gets fresh ones
+        rgb_matrix_mode_noeeprom(mode);
+        for (uint8_t i = 0; i < 8; i++) {
+            process_rgb_matrix(i, i, true);
+            process_rgb_matrix(i, i, false);
+        }
+        idle_for(100);
+
+        std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+        uint32_t                 flushes = test_led_flushes;
+        while (test_led_flushes - flushes < 200) {
+            uint32_t writes = test_led_writes;
+            auto     start  = std::chrono::steady_clock::now();
+            rgb_matrix_task();
+            auto spent = std::chrono::steady_clock::now() - start;
+            if (test_led_writes != writes) best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(spent));
+            advance_time(1);
+        }
+
+        EXPECT_LT(best, std::chrono::nanoseconds::max()) << test_effect_names[mode] << " never rendered";
+        RecordProperty(std::string(test_effect_names[mode]) + "_ns_per_frame", (int)best.count());
+    }
+}
@@ -0,0 +1,109 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+/* hsv_to_rgb as it was before the hue region lost its division, kept as the
+ * reference the current one has to match.
+ */
+static RGB reference_hsv_to_rgb(HSV hsv, bool use_cie) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h = hsv.h, s = hsv.s, v = use_cie ? pgm_read_byte(&CIE1931_CURVE[hsv.v]) : hsv.v;
+
+    if (s == 0) {
+        rgb.r = rgb.g = rgb.b = v;
+        return rgb;
+    }
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v, rgb.g = t, rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q, rgb.g = v, rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p, rgb.g = v, rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p, rgb.g = q, rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t, rgb.g = p, rgb.b = v;
+            break;
+        default:
+            rgb.r = v, rgb.g = p, rgb.b = q;
+            break;
+    }
+    return rgb;
+}
+
+static bool same_rgb(RGB a, RGB b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+TEST(Color, HsvToRgbMatchesTheDivisionForAllInputs) {
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < (1UL << 24); i++) {
+        HSV hsv = {.h = (uint8_t)(i >> 16), .s = (uint8_t)(i >> 8), .v = (uint8_t)i};
+        if (!same_rgb(hsv_to_rgb(hsv), reference_hsv_to_rgb(hsv, true))) mismatches++;
+        if (!same_rgb(hsv_to_rgb_nocie(hsv), reference_hsv_to_rgb(hsv, false))) mismatches++;
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+/* Not a pass/fail test. Times both over all inputs and records the cost per
+ * call; the host divides in hardware, so the gap is far smaller than on AVR.
+ */
+TEST(Color, HsvToRgbBenchmark) {
+    volatile uint8_t sink = 0;
+
+    auto time_all = [&](RGB (*convert)(HSV)) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < (1UL << 24); i++) {
+            HSV hsv = {.h = (uint8_t)(i >> 16), .s = (uint8_t)(i >> 8), .v = (uint8_t)i};
+            sink    = sink + convert(hsv).r;
+        }
+        return std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count() * 1000 / (1LL << 24);
+    };
+
+    RecordProperty("hsv_to_rgb_ps_per_call", time_all(hsv_to_rgb_nocie));
+    RecordProperty("reference_ps_per_call", time_all([](HSV hsv) { return reference_hsv_to_rgb(hsv, false); }));
+}
+
+TEST(Color, CurrentScale) {
+    // 60mA at 20mA per channel is a budget of 765, one LED in white
+    EXPECT_EQ(rgb_current_scale(765, 20, 60), 256);
+    EXPECT_EQ(rgb_current_scale(0, 20, 60), 256);
+    EXPECT_EQ(rgb_current_scale(1530, 20, 60), 128);
+    EXPECT_EQ(rgb_current_scale(3060, 20, 60), 64);
+    // a limit of zero blanks every lit frame, no current per channel never limits
+    EXPECT_EQ(rgb_current_scale(1, 20, 0), 0);
+    EXPECT_EQ(rgb_current_scale(3060, 0, 60), 256);
+}
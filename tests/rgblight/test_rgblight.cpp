@@ -0,0 +1,94 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgblight.h"
+
+extern LED_TYPE          test_led_values[RGBLED_NUM];
+extern uint32_t          test_led_sends;
+extern LED_TYPE          led[RGBLED_NUM];
+extern rgblight_config_t rgblight_config;
+extern rgblight_status_t rgblight_status;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class Rgblight : public TestFixture {
+   public:
+    Rgblight() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        rgblight_enable_noeeprom();
+        rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+        rgblight_sethsv_noeeprom(0, 0, 0);
+        test_led_sends = 0;
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(Rgblight, RepeatedFramesAreNotResent) {
+    rgblight_setrgb_at(10, 20, 30, 1);
+    EXPECT_EQ(test_led_sends, 1);
+    rgblight_set();
+    rgblight_setrgb_at(10, 20, 30, 1);
+    EXPECT_EQ(test_led_sends, 1);
+}
+
+TEST_F(Rgblight, ChangesThatCollideUnderAHashStillReachTheStrip) {
+    // (0, 33) and (1, 0) hash the same under djb2: 33 * 0 + 33 == 33 * 1 + 0
+    uint8_t *bytes = (uint8_t *)&led[2];
+    bytes[0]       = 0;
+    bytes[1]       = 33;
+    rgblight_set();
+    EXPECT_EQ(test_led_sends, 1);
+
+    bytes[0] = 1;
+    bytes[1] = 0;
+    rgblight_set();
+    EXPECT_EQ(test_led_sends, 2);
+    EXPECT_EQ(memcmp(&test_led_values[2], &led[2], sizeof(LED_TYPE)), 0);
+}
+
+TEST_F(Rgblight, StaticModesTurnTheTimerOff) {
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_BREATHING);
+    EXPECT_TRUE(rgblight_status.timer_enabled);
+
+    // switched straight to a static mode, without going through rgblight_mode()
+    rgblight_config.mode = RGBLIGHT_MODE_STATIC_LIGHT;
+    rgblight_timer_enable();
+    EXPECT_FALSE(rgblight_status.timer_enabled);
+}
+
+TEST_F(Rgblight, FramesWithinTheCurrentBudgetAreSentAsTheyAre) {
+    rgblight_setrgb_at(255, 255, 255, 0);
+    EXPECT_EQ(test_led_values[0].r, 255);
+    EXPECT_EQ(test_led_values[0].g, 255);
+    EXPECT_EQ(test_led_values[0].b, 255);
+}
+
+TEST_F(Rgblight, FramesOverTheCurrentBudgetAreDimmed) {
+    rgblight_setrgb(255, 255, 255);
+    // four LEDs in white against a budget for one
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        EXPECT_EQ(test_led_values[i].r, 63);
+        EXPECT_EQ(test_led_values[i].g, 63);
+        EXPECT_EQ(test_led_values[i].b, 63);
+        EXPECT_EQ(led[i].r, 255);
+    }
+}
@@ -0,0 +1,26 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#define MATRIX_ROWS 1
+#define MATRIX_COLS 1
+
+#define RGBLED_NUM 4
+#define RGBW
+#define RGBLIGHT_LED_MAP {3, 2, 1, 0}
+// enough for two LEDs at full white, which the RGBW conversion sends on the white channel alone
+#define RGBLIGHT_CURRENT_LIMIT 40
+#define RGBLIGHT_CHANNEL_CURRENT 20
@@ -0,0 +1,113 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <algorithm>
+
+extern "C" {
+#include "rgblight.h"
+
+extern LED_TYPE test_led_values[RGBLED_NUM];
+extern uint32_t test_led_sends;
+extern LED_TYPE led[RGBLED_NUM];
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class RgblightRgbw : public TestFixture {
+   public:
+    RgblightRgbw() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        rgblight_enable_noeeprom();
+        rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+        rgblight_sethsv_noeeprom(0, 0, 0);
+        test_led_sends = 0;
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(RgblightRgbw, WhiteIsBudgetedOnTheWhiteChannel) {
+    rgblight_setrgb_at(255, 255, 255, 0);
+    rgblight_setrgb_at(255, 255, 255, 1);
+    // sent reversed by the map, with r, g and b moved to w
+    for (int i = 2; i < RGBLED_NUM; i++) {
+        EXPECT_EQ(test_led_values[i].w, 255);
+        EXPECT_EQ(test_led_values[i].r, 0);
+    }
+}
+
+TEST_F(RgblightRgbw, FramesOverTheCurrentBudgetAreDimmedAfterTheConversion) {
+    rgblight_setrgb(255, 255, 255);
+    // four LEDs in white against a budget for two
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        EXPECT_EQ(test_led_values[i].w, 127);
+        EXPECT_EQ(test_led_values[i].r, 0);
+    }
+
+    // led[] keeps the requested colors, so sending again gives the same frame
+    rgblight_set();
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        EXPECT_EQ(test_led_values[i].w, 127);
+        EXPECT_EQ(led[i].r, 255);
+    }
+}
+
+TEST_F(RgblightRgbw, ColorsKeepTheirWhiteOverRepeatedSends) {
+    rgblight_setrgb_at(40, 30, 20, 3);
+    rgblight_set();
+    rgblight_set();
+    EXPECT_EQ(test_led_values[0].w, 20);
+    EXPECT_EQ(test_led_values[0].r, 20);
+    EXPECT_EQ(test_led_values[0].g, 10);
+    EXPECT_EQ(test_led_values[0].b, 0);
+}
+
+TEST_F(RgblightRgbw, MappedSendsMatchCopyingThenSending) {
+    LED_TYPE       frame[RGBLED_NUM] = {{.g = 10, .r = 200, .b = 30}, {.g = 60, .r = 60, .b = 60}, {.g = 0, .r = 0, .b = 0}, {.g = 255, .r = 1, .b = 128}};
+    LED_TYPE       sent[RGBLED_NUM];
+    const uint8_t  map[] = {2, 0, 3, 1};
+    const LED_TYPE before[RGBLED_NUM] = {frame[0], frame[1], frame[2], frame[3]};
+
+    // the whole strip, and one clipped short of it
+    for (uint16_t count = RGBLED_NUM; count >= RGBLED_NUM - 1; count--) {
+        ws2812_setleds_mapped(frame, map, count);
+        std::copy(test_led_values, test_led_values + count, sent);
+
+        LED_TYPE copy[RGBLED_NUM];
+        for (uint16_t i = 0; i < count; i++) {
+            copy[i] = frame[map[i]];
+            convert_rgb_to_rgbw(&copy[i]);
+        }
+        ws2812_setleds(copy, count);
+
+        for (uint16_t i = 0; i < count; i++) {
+            EXPECT_EQ(sent[i].r, test_led_values[i].r) << i;
+            EXPECT_EQ(sent[i].g, test_led_values[i].g) << i;
+            EXPECT_EQ(sent[i].b, test_led_values[i].b) << i;
+            EXPECT_EQ(sent[i].w, test_led_values[i].w) << i;
+        }
+    }
+
+    // the frame itself is left as it was
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        EXPECT_EQ(frame[i].r, before[i].r);
+        EXPECT_EQ(frame[i].g, before[i].g);
+        EXPECT_EQ(frame[i].b, before[i].b);
+        EXPECT_EQ(frame[i].w, before[i].w);
+    }
+}
@@ -0,0 +1,55 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <stdint.h>
+
+extern "C" void advance_time(uint32_t ms);
+
+// led_matrix and rgb_matrix are benchmarked with the same number of LEDs
+#define MATRIX_BENCHMARK_LEDS 40
+
+struct matrix_benchmark_t {
+    long long ns_per_task;
+    long long worst_ns;
+};
+
+/* Runs 'task' once per ms for 10 seconds while typing: a key is hit through
+ * 'hit(row, col, pressed)' every 40ms, walking the matrix.
+ */
+template <typename Task, typename Hit>
+matrix_benchmark_t run_matrix_benchmark(Task task, Hit hit) {
+    static_assert(DRIVER_LED_TOTAL == MATRIX_BENCHMARK_LEDS, "both matrix benchmarks need the same LED count");
+
+    std::chrono::nanoseconds total{0}, worst{0};
+    const int                calls = 10000;
+    for (int i = 0; i < calls; i++) {
+        if (i % 40 == 0) {
+            hit((i / 40) % MATRIX_ROWS, (i / 40) % MATRIX_COLS, true);
+            hit((i / 40) % MATRIX_ROWS, (i / 40) % MATRIX_COLS, false);
+        }
+        auto start = std::chrono::steady_clock::now();
+        task();
+        auto spent = std::chrono::steady_clock::now() - start;
+        total += spent;
+        worst = std::max(worst, spent);
+        advance_time(1);
+    }
+    return {(long long)(total.count() / calls), (long long)worst.count()};
+}
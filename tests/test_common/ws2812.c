@@ -0,0 +1,28 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ws2812.h"
+
+// Stands in for the strip of the rgblight tests, recording what reaches it
+LED_TYPE test_led_values[RGBLED_NUM];
+uint32_t test_led_sends;
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    for (uint16_t i = 0; i < number_of_leds; i++) {
+        test_led_values[i] = ledarray[i];
+    }
+    test_led_sends++;
+}
@@ -0,0 +1,120 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <vector>
+
+extern "C" {
+#include "wpm.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class Wpm : public TestFixture {
+   public:
+    Wpm() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        // forget the previous test's typing
+        idle_for(WPM_WINDOW + WPM_SAMPLE_PERIOD);
+        set_current_wpm(0);
+    }
+
+    // Types the key at col, row once, then waits for the rest of 'interval' ms
+    void type(uint8_t col, uint8_t row, unsigned interval) {
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+        idle_for(interval - 2);
+    }
+
+    // Types KC_A, cycling through the intervals, for 'duration' ms
+    void type_stream(std::vector<unsigned> intervals, unsigned duration) {
+        for (unsigned elapsed = 0, i = 0; elapsed < duration; elapsed += intervals[i], i = (i + 1) % intervals.size()) {
+            type(0, 0, intervals[i]);
+        }
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(Wpm, SteadyTypingSettlesOnItsRate) {
+    // 5 keystrokes per second are 60 WPM
+    type_stream({200}, 20000);
+    EXPECT_EQ(get_burst_wpm(), 60);
+    EXPECT_NEAR(get_current_wpm(), 60, 1);
+
+    type_stream({100}, 20000);
+    EXPECT_EQ(get_burst_wpm(), 120);
+    EXPECT_NEAR(get_current_wpm(), 120, 1);
+}
+
+TEST_F(Wpm, UnevenTypingDoesNotJitter) {
+    type_stream({120, 280}, 20000);
+    uint8_t min_wpm = 255, max_wpm = 0;
+    for (int i = 0; i < 50; i++) {
+        type_stream({120, 280}, 400);
+        min_wpm = std::min(min_wpm, get_current_wpm());
+        max_wpm = std::max(max_wpm, get_current_wpm());
+    }
+    // a single interval rates these keystrokes at 42 and 100 WPM
+    EXPECT_GE(min_wpm, 57);
+    EXPECT_LE(max_wpm, 63);
+}
+
+TEST_F(Wpm, BurstLeadsTheCurrentWpm) {
+    type_stream({200}, 20000);
+    type_stream({60}, 1500);
+    EXPECT_EQ(get_burst_wpm(), 200);
+    EXPECT_GT(get_current_wpm(), 60);
+    EXPECT_LT(get_current_wpm(), 150);
+}
+
+TEST_F(Wpm, DecaysWhenTypingStops) {
+    type_stream({150}, 20000);
+    EXPECT_NEAR(get_current_wpm(), 80, 1);
+
+    idle_for(1000);
+    EXPECT_LT(get_burst_wpm(), 80);
+    EXPECT_LT(get_current_wpm(), 80);
+
+    idle_for(WPM_WINDOW);
+    EXPECT_EQ(get_burst_wpm(), 0);
+    idle_for(WPM_SAMPLE_PERIOD * WPM_SMOOTHING * 6);
+    EXPECT_EQ(get_current_wpm(), 0);
+}
+
+TEST_F(Wpm, KeepsFractionalPrecision) {
+    // 6 keystrokes per 7 seconds are 10.29 WPM
+    type_stream({1167, 1167, 1166}, 60000);
+    EXPECT_EQ(get_current_wpm(), 10);
+    EXPECT_NEAR(get_current_wpm_fixed(), 10.29 * 256, 8);
+}
+
+TEST_F(Wpm, IgnoresKeycodesNotCountedAsTyping) {
+    for (int i = 0; i < 100; i++) {
+        type(1, 0, 100);
+    }
+    EXPECT_EQ(get_burst_wpm(), 0);
+    EXPECT_EQ(get_current_wpm(), 0);
+}
+
+TEST_F(Wpm, SetCurrentWpmForTheSlaveHalf) {
+    set_current_wpm(87);
+    EXPECT_EQ(get_current_wpm(), 87);
+    EXPECT_EQ(get_current_wpm_fixed(), 87 * 256);
+}
@@ -17,6 +17,34 @@
 #    include "haptic.h"
 #endif
 
+/* RAM copies of the values that are read while scanning or processing keys,
+ * so those reads never reach the (possibly flash emulated) EEPROM. They are
+ * loaded on first use and the eeconfig_update_* functions write through both.
+ */
+typedef struct {
+    bool     loaded;
+    uint8_t  debug;
+    uint16_t keymap;
+    uint8_t  audio;
+    uint8_t  velocikey;
+    uint32_t haptic;
+} eeconfig_cache_t;
+
+static eeconfig_cache_t eeconfig_cache;
+
+static eeconfig_cache_t *eeconfig_cached(void) {
+    if (eeconfig_cache.loaded) {
+        return &eeconfig_cache;
+    }
+    eeconfig_cache.debug     = eeprom_read_byte(EECONFIG_DEBUG);
+    eeconfig_cache.keymap    = eeprom_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeprom_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8);
+    eeconfig_cache.audio     = eeprom_read_byte(EECONFIG_AUDIO);
+    eeconfig_cache.velocikey = eeprom_read_byte(EECONFIG_VELOCIKEY);
+    eeconfig_cache.haptic    = eeprom_read_dword(EECONFIG_HAPTIC);
+    eeconfig_cache.loaded    = true;
+    return &eeconfig_cache;
+}
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -79,6 +107,9 @@ void eeconfig_init_quantum(void) {
 #endif
 
     eeconfig_init_kb();
+
+    // written behind the cache's back, reload on next use
+    eeconfig_cache.loaded = false;
 }
 
 /** \brief eeconfig initialization
@@ -105,6 +136,7 @@ void eeconfig_disable(void) {
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+    eeconfig_cache.loaded = false;
 }
 
 /** \brief eeconfig is enabled
@@ -123,12 +155,15 @@ bool eeconfig_is_disabled(void) { return (eeprom_read_word(EECONFIG_MAGIC) == EE
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_debug(void) { return eeprom_read_byte(EECONFIG_DEBUG); }
+uint8_t eeconfig_read_debug(void) { return eeconfig_cached()->debug; }
 /** \brief eeconfig update debug
  *
  * FIXME: needs doc
  */
-void eeconfig_update_debug(uint8_t val) { eeprom_update_byte(EECONFIG_DEBUG, val); }
+void eeconfig_update_debug(uint8_t val) {
+    eeconfig_cache.debug = val;
+    eeprom_update_byte(EECONFIG_DEBUG, val);
+}
 
 /** \brief eeconfig read default layer
  *
@@ -145,12 +180,13 @@ void eeconfig_update_default_layer(uint8_t val) { eeprom_update_byte(EECONFIG_DE
  *
  * FIXME: needs doc
  */
-uint16_t eeconfig_read_keymap(void) { return (eeprom_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeprom_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8)); }
+uint16_t eeconfig_read_keymap(void) { return eeconfig_cached()->keymap; }
 /** \brief eeconfig update keymap
  *
  * FIXME: needs doc
  */
 void eeconfig_update_keymap(uint16_t val) {
+    eeconfig_cache.keymap = val;
     eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
     eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
 }
@@ -170,12 +206,15 @@ void eeconfig_update_backlight(uint8_t val) { eeprom_update_byte(EECONFIG_BACKLI
  *
  * FIXME: needs doc
  */
-uint8_t eeconfig_read_audio(void) { return eeprom_read_byte(EECONFIG_AUDIO); }
+uint8_t eeconfig_read_audio(void) { return eeconfig_cached()->audio; }
 /** \brief eeconfig update audio
  *
  * FIXME: needs doc
  */
-void eeconfig_update_audio(uint8_t val) { eeprom_update_byte(EECONFIG_AUDIO, val); }
+void eeconfig_update_audio(uint8_t val) {
+    eeconfig_cache.audio = val;
+    eeprom_update_byte(EECONFIG_AUDIO, val);
+}
 
 /** \brief eeconfig read kb
  *
@@ -203,12 +242,29 @@ void eeconfig_update_user(uint32_t val) { eeprom_update_dword(EECONFIG_USER, val
  *
  * FIXME: needs doc
  */
-uint32_t eeconfig_read_haptic(void) { return eeprom_read_dword(EECONFIG_HAPTIC); }
+uint32_t eeconfig_read_haptic(void) { return eeconfig_cached()->haptic; }
 /** \brief eeconfig update haptic
  *
  * FIXME: needs doc
  */
-void eeconfig_update_haptic(uint32_t val) { eeprom_update_dword(EECONFIG_HAPTIC, val); }
+void eeconfig_update_haptic(uint32_t val) {
+    eeconfig_cache.haptic = val;
+    eeprom_update_dword(EECONFIG_HAPTIC, val);
+}
+
+/** \brief eeconfig read velocikey
+ *
+ * FIXME: needs doc
+ */
+uint8_t eeconfig_read_velocikey(void) { return eeconfig_cached()->velocikey; }
+/** \brief eeconfig update velocikey
+ *
+ * FIXME: needs doc
+ */
+void eeconfig_update_velocikey(uint8_t val) {
+    eeconfig_cache.velocikey = val;
+    eeprom_update_byte(EECONFIG_VELOCIKEY, val);
+}
 
 /** \brief eeconfig read split handedness
  *
@@ -108,5 +108,8 @@ uint32_t eeconfig_read_haptic(void);
 void     eeconfig_update_haptic(uint32_t val);
 #endif
 
+uint8_t eeconfig_read_velocikey(void);
+void    eeconfig_update_velocikey(uint8_t val);
+
 bool eeconfig_read_handedness(void);
 void eeconfig_update_handedness(bool val);
@@ -127,6 +127,16 @@ enum desktop_usages {
 
 #define KEYBOARD_REPORT_KEYS 6
 
+/* mouse report x/y range, 16bit with MOUSE_EXTENDED_REPORT for high resolution sensors */
+#ifdef MOUSE_EXTENDED_REPORT
+#    if defined(PROTOCOL_ARM_ATSAM)
+#        error "MOUSE_EXTENDED_REPORT not supported with this protocol"
+#    endif
+#    define MOUSE_REPORT_XY_MAX 32767
+#else
+#    define MOUSE_REPORT_XY_MAX 127
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -182,10 +192,15 @@ typedef struct {
     uint8_t report_id;
 #endif
     uint8_t buttons;
-    int8_t  x;
-    int8_t  y;
-    int8_t  v;
-    int8_t  h;
+#ifdef MOUSE_EXTENDED_REPORT
+    int16_t x;
+    int16_t y;
+#else
+    int8_t x;
+    int8_t y;
+#endif
+    int8_t v;
+    int8_t h;
 } __attribute__((packed)) report_mouse_t;
 
 typedef struct {
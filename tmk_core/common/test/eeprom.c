@@ -16,12 +16,16 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+#define EEPROM_SIZE 64
 
 static uint8_t buffer[EEPROM_SIZE];
 
+// for tests asserting that hot paths stay off the EEPROM
+uint32_t eeprom_read_count = 0;
+
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uintptr_t offset = (uintptr_t)addr;
+    eeprom_read_count++;
     return buffer[offset];
 }
 
@@ -85,8 +85,8 @@ void serial_mouse_task(void) {
     if (buffer[0] & (1 << 5)) report.buttons |= MOUSE_BTN1;
     if (buffer[0] & (1 << 4)) report.buttons |= MOUSE_BTN2;
 
-    report.x = (buffer[0] << 6) | buffer[1];
-    report.y = ((buffer[0] << 4) & 0xC0) | buffer[2];
+    report.x = (int8_t)((buffer[0] << 6) | buffer[1]);
+    report.y = (int8_t)(((buffer[0] << 4) & 0xC0) | buffer[2]);
 
     /* USB HID uses values from -127 to 127 only */
     report.x = MAX(report.x, -127);
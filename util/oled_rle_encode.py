@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+#
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Encodes a raw OLED image, in the same layout as the OLED display buffer,
+# for oled_write_raw_rle_P. The input is a binary file, the output a C array.
+#
+# usage: oled_rle_encode.py image.bin name
+
+import sys
+
+MAX_LITERAL = 128
+MAX_REPEAT = 129
+
+
+def encode(data):
+    out = []
+    literal = []
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < MAX_REPEAT and data[i + run] == data[i]:
+            run += 1
+        if run >= 3 or (run == 2 and not literal):
+            if literal:
+                out += [len(literal) - 1] + literal
+                literal = []
+            out += [run + 126, data[i]]
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+            if len(literal) == MAX_LITERAL:
+                out += [len(literal) - 1] + literal
+                literal = []
+    if literal:
+        out += [len(literal) - 1] + literal
+    return out
+
+
+if __name__ == '__main__':
+    with open(sys.argv[1], 'rb') as f:
+        raw = list(f.read())
+    encoded = encode(raw)
+    print('// %d bytes encoded from %d' % (len(encoded), len(raw)))
+    print('static const char PROGMEM %s[] = {' % sys.argv[2])
+    for i in range(0, len(encoded), 16):
+        print('    ' + ', '.join('0x%02X' % b for b in encoded[i:i + 16]) + ',')
+    print('};')